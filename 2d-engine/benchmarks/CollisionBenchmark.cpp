@@ -0,0 +1,312 @@
+/////////////////////////////////////////////////////////////////////////////////
+// Collision benchmark
+/////////////////////////////////////////////////////////////////////////////////
+// Headless benchmark of the CollisionSystem, it does not need SDL, a window
+// or any asset. It builds synthetic Registry scenes with N colliders and times
+// the broadphase, the narrowphase and the event dispatch separately.
+// With --queued the collision events are queued and handled in one batch.
+// With --threads N as well the narrowphase runs on a ThreadPool and emits the
+// events into the lanes of the queue, the emission counts as narrowphase then.
+//
+// Build and run it on a plain Linux box from the 2d-engine folder:
+//   g++ -std=c++17 -O2 -Ilibs -Isrc benchmarks/CollisionBenchmark.cpp src/ECS/ECS.cpp src/Profiler/Profiler.cpp src/EventBus/EventRecorder.cpp src/Timing/TimerWheel.cpp src/Threading/ThreadPool.cpp -pthread -o collision-benchmark
+//   ./collision-benchmark --entities 250,500,1000,2000 --frames 60 [--queued [--threads N]] --output collision-benchmark.json
+/////////////////////////////////////////////////////////////////////////////////
+#include "../src/ECS/ECS.h"
+#include "../src/EventBus/EventBus.h"
+#include "../src/Events/CollisionEvent.h"
+#include "../src/Components/TransformComponent.h"
+#include "../src/Components/RigidBodyComponent.h"
+#include "../src/Components/BoxColliderComponent.h"
+#include "../src/Systems/MovementSystem.h"
+#include "../src/Systems/CollisionSystem.h"
+#include <spdlog/spdlog.h>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+enum SceneDistribution {
+	SCENE_UNIFORM,
+	SCENE_CLUSTERED,
+	SCENE_CONVOY
+};
+
+const char* SceneDistributionName(SceneDistribution distribution) {
+	switch (distribution) {
+		case SCENE_UNIFORM: return "uniform";
+		case SCENE_CLUSTERED: return "clustered";
+		case SCENE_CONVOY: return "convoy";
+	}
+	return "unknown";
+}
+
+struct BenchmarkResult {
+	SceneDistribution distribution;
+	int numEntities;
+	int numFrames;
+	double broadphaseNs = 0;
+	double narrowphaseNs = 0;
+	double dispatchNs = 0;
+	size_t numCandidatePairs = 0;
+	size_t numCollisions = 0;
+	size_t numEventsReceived = 0;
+};
+
+// Counts the collision events, the real DamageSystem would kill the entities and change the scene
+class CollisionCounter {
+public:
+	size_t numEvents = 0;
+
+	void OnCollision(CollisionEvent&) {
+		numEvents++;
+	}
+
+	void OnCollisions(EventSpan<CollisionEvent> events) {
+		numEvents += events.size();
+	}
+};
+
+const int COLLIDER_SIZE = 32;
+
+// The world grows with the number of entities so the density of the scenes stays the same
+float WorldSizeFor(int numEntities) {
+	return std::sqrt(static_cast<float>(numEntities)) * COLLIDER_SIZE * 4.0f;
+}
+
+void CreateCollider(Registry& registry, glm::vec2 position, glm::vec2 velocity) {
+	Entity entity = registry.CreateEntity();
+	entity.AddComponent<TransformComponent>(position, glm::vec2(1.0, 1.0), 0.0);
+	entity.AddComponent<RigidBodyComponent>(velocity);
+	entity.AddComponent<BoxColliderComponent>(COLLIDER_SIZE, COLLIDER_SIZE);
+}
+
+void BuildScene(Registry& registry, SceneDistribution distribution, int numEntities, unsigned int seed) {
+	std::mt19937 random(seed);
+	const float worldSize = WorldSizeFor(numEntities);
+
+	switch (distribution) {
+		case SCENE_UNIFORM: {
+			// Static colliders spread all over the world
+			std::uniform_real_distribution<float> coordinate(0.0f, worldSize);
+			for (int i = 0; i < numEntities; i++) {
+				CreateCollider(registry, glm::vec2(coordinate(random), coordinate(random)), glm::vec2(0.0));
+			}
+			break;
+		}
+		case SCENE_CLUSTERED: {
+			// Static colliders packed around a few hot spots, one cluster every 64 entities
+			const int numClusters = std::max(1, numEntities / 64);
+			std::uniform_real_distribution<float> coordinate(0.0f, worldSize);
+			std::normal_distribution<float> spread(0.0f, COLLIDER_SIZE * 3.0f);
+			std::vector<glm::vec2> centers;
+			for (int i = 0; i < numClusters; i++) {
+				centers.emplace_back(coordinate(random), coordinate(random));
+			}
+			for (int i = 0; i < numEntities; i++) {
+				const auto& center = centers[i % numClusters];
+				CreateCollider(registry, center + glm::vec2(spread(random), spread(random)), glm::vec2(0.0));
+			}
+			break;
+		}
+		case SCENE_CONVOY: {
+			// Rows of vehicles driving in opposite directions so the convoys cross each other
+			const int vehiclesPerConvoy = 16;
+			const float spacing = COLLIDER_SIZE * 1.5f;
+			const int numConvoys = std::max(1, numEntities / vehiclesPerConvoy);
+			std::uniform_real_distribution<float> coordinate(0.0f, worldSize);
+			std::uniform_real_distribution<float> speed(30.0f, 120.0f);
+			for (int i = 0; i < numEntities; i++) {
+				const int convoy = i % numConvoys;
+				const int slot = i / numConvoys;
+				const bool isHorizontal = (convoy % 2) == 0;
+				// Every convoy keeps the same random start and speed for all its vehicles
+				std::mt19937 convoyRandom(seed + convoy);
+				const glm::vec2 start(coordinate(convoyRandom), coordinate(convoyRandom));
+				const float convoySpeed = speed(convoyRandom) * ((convoy % 4) < 2 ? 1.0f : -1.0f);
+				if (isHorizontal) {
+					CreateCollider(registry, start + glm::vec2(slot * spacing, 0.0f), glm::vec2(convoySpeed, 0.0f));
+				}
+				else {
+					CreateCollider(registry, start + glm::vec2(0.0f, slot * spacing), glm::vec2(0.0f, convoySpeed));
+				}
+			}
+			break;
+		}
+	}
+}
+
+BenchmarkResult RunBenchmark(SceneDistribution distribution, int numEntities, int numFrames, unsigned int seed, bool isQueued, ThreadPool* threadPool) {
+	using Clock = std::chrono::steady_clock;
+
+	auto registry = std::make_unique<Registry>();
+	auto eventBus = std::make_unique<EventBus>();
+	CollisionCounter counter;
+
+	registry->AddSystem<MovementSystem>();
+	registry->AddSystem<CollisionSystem>();
+	BuildScene(*registry, distribution, numEntities, seed);
+	registry->Update();
+
+	if (isQueued) {
+		eventBus->SetQueued<CollisionEvent>(true);
+		eventBus->SubscribeToEventBatch<CollisionEvent>(&counter, &CollisionCounter::OnCollisions);
+	}
+	else {
+		eventBus->SubscribeToEvent<CollisionEvent>(&counter, &CollisionCounter::OnCollision);
+	}
+
+	auto& movementSystem = registry->GetSystem<MovementSystem>();
+	auto& collisionSystem = registry->GetSystem<CollisionSystem>();
+	collisionSystem.SetThreadPool(threadPool);
+
+	BenchmarkResult result;
+	result.distribution = distribution;
+	result.numEntities = numEntities;
+	result.numFrames = numFrames;
+
+	for (int frame = 0; frame < numFrames; frame++) {
+		// Only the convoys move, the movement is not part of the measure
+		movementSystem.Update(1.0 / 60.0);
+
+		auto start = Clock::now();
+		collisionSystem.UpdateBroadphase();
+		auto broadphaseEnd = Clock::now();
+		if (threadPool) {
+			collisionSystem.UpdateNarrowphaseParallel(*eventBus);
+		}
+		else {
+			collisionSystem.UpdateNarrowphase();
+		}
+		auto narrowphaseEnd = Clock::now();
+		if (!threadPool) {
+			collisionSystem.DispatchCollisionEvents(eventBus);
+		}
+		eventBus->DispatchQueuedEvents();
+		auto dispatchEnd = Clock::now();
+
+		result.broadphaseNs += std::chrono::duration<double, std::nano>(broadphaseEnd - start).count();
+		result.narrowphaseNs += std::chrono::duration<double, std::nano>(narrowphaseEnd - broadphaseEnd).count();
+		result.dispatchNs += std::chrono::duration<double, std::nano>(dispatchEnd - narrowphaseEnd).count();
+		result.numCandidatePairs += collisionSystem.GetNumCandidatePairs();
+		result.numCollisions += collisionSystem.GetNumCollisions();
+	}
+	result.numEventsReceived = counter.numEvents;
+
+	return result;
+}
+
+std::vector<int> ParseIntList(const std::string& text) {
+	std::vector<int> values;
+	std::stringstream stream(text);
+	std::string item;
+	while (std::getline(stream, item, ',')) {
+		values.push_back(std::stoi(item));
+	}
+	return values;
+}
+
+std::string ResultsToJson(const std::vector<BenchmarkResult>& results, unsigned int seed, bool isQueued, int numThreads) {
+	std::ostringstream json;
+	json << "{\n";
+	json << "  \"benchmark\": \"collision\",\n";
+	json << "  \"seed\": " << seed << ",\n";
+	json << "  \"queued_events\": " << (isQueued ? "true" : "false") << ",\n";
+	json << "  \"narrowphase_threads\": " << numThreads << ",\n";
+	json << "  \"results\": [\n";
+	for (size_t i = 0; i < results.size(); i++) {
+		const auto& result = results[i];
+		const double frames = result.numFrames;
+		const double totalNs = result.broadphaseNs + result.narrowphaseNs + result.dispatchNs;
+		json << "    {";
+		json << "\"distribution\": \"" << SceneDistributionName(result.distribution) << "\", ";
+		json << "\"entities\": " << result.numEntities << ", ";
+		json << "\"frames\": " << result.numFrames << ", ";
+		json << "\"broadphase_ns_per_entity\": " << result.broadphaseNs / frames / result.numEntities << ", ";
+		json << "\"narrowphase_ns_per_entity\": " << result.narrowphaseNs / frames / result.numEntities << ", ";
+		json << "\"dispatch_ns_per_entity\": " << result.dispatchNs / frames / result.numEntities << ", ";
+		json << "\"total_ns_per_entity\": " << totalNs / frames / result.numEntities << ", ";
+		json << "\"candidate_pairs_per_frame\": " << result.numCandidatePairs / frames << ", ";
+		json << "\"collisions_per_frame\": " << result.numCollisions / frames << ", ";
+		json << "\"candidate_pairs_per_second\": " << (result.narrowphaseNs > 0 ? result.numCandidatePairs / (result.narrowphaseNs * 1e-9) : 0.0) << ", ";
+		json << "\"events_per_second\": " << (result.dispatchNs > 0 ? result.numEventsReceived / (result.dispatchNs * 1e-9) : 0.0);
+		json << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+	}
+	json << "  ]\n";
+	json << "}\n";
+	return json.str();
+}
+
+int main(int argc, char* argv[]) {
+	std::vector<int> entityCounts = { 250, 500, 1000, 2000 };
+	int numFrames = 60;
+	unsigned int seed = 1234;
+	std::string outputPath = "collision-benchmark.json";
+	bool isQueued = false;
+	int numThreads = 0;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--entities" && i + 1 < argc) {
+			entityCounts = ParseIntList(argv[++i]);
+		}
+		else if (arg == "--frames" && i + 1 < argc) {
+			numFrames = std::stoi(argv[++i]);
+		}
+		else if (arg == "--seed" && i + 1 < argc) {
+			seed = static_cast<unsigned int>(std::stoul(argv[++i]));
+		}
+		else if (arg == "--output" && i + 1 < argc) {
+			outputPath = argv[++i];
+		}
+		else if (arg == "--queued") {
+			isQueued = true;
+		}
+		else if (arg == "--threads" && i + 1 < argc) {
+			numThreads = std::stoi(argv[++i]);
+		}
+		else {
+			std::cerr << "Usage: " << argv[0] << " [--entities 250,500,...] [--frames N] [--seed N] [--queued [--threads N]] [--output file.json]" << std::endl;
+			return 1;
+		}
+	}
+
+	// The registry logs every entity and component, that would be measured too
+	spdlog::set_level(spdlog::level::warn);
+
+	// The workers emit into the lanes of the queue, without it there is nothing to emit into
+	if (numThreads > 0 && !isQueued) {
+		std::cerr << "--threads needs --queued" << std::endl;
+		return 1;
+	}
+	std::unique_ptr<ThreadPool> threadPool;
+	if (numThreads > 0) {
+		threadPool = std::make_unique<ThreadPool>(numThreads);
+	}
+
+	std::vector<BenchmarkResult> results;
+	for (auto distribution : { SCENE_UNIFORM, SCENE_CLUSTERED, SCENE_CONVOY }) {
+		for (int numEntities : entityCounts) {
+			BenchmarkResult result = RunBenchmark(distribution, numEntities, numFrames, seed, isQueued, threadPool.get());
+			const double frames = result.numFrames;
+			std::cout
+				<< SceneDistributionName(distribution) << " n=" << numEntities
+				<< " broadphase=" << result.broadphaseNs / frames / numEntities << "ns/entity"
+				<< " narrowphase=" << result.narrowphaseNs / frames / numEntities << "ns/entity"
+				<< " dispatch=" << result.dispatchNs / frames / numEntities << "ns/entity"
+				<< " collisions/frame=" << result.numCollisions / frames
+				<< std::endl;
+			results.push_back(result);
+		}
+	}
+
+	std::ofstream output(outputPath);
+	output << ResultsToJson(results, seed, isQueued, numThreads);
+	std::cout << "Results written to " << outputPath << std::endl;
+
+	return 0;
+}
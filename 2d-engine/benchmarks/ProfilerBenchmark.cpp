@@ -0,0 +1,98 @@
+/////////////////////////////////////////////////////////////////////////////////
+// Profiler benchmark
+/////////////////////////////////////////////////////////////////////////////////
+// Measures what a PROFILE_SCOPE marker costs with the capture stopped and with
+// it running, on one thread and on several threads recording at once. The
+// scopes are nested two levels deep like the systems inside Game::Update.
+//
+// Build and run it on a plain Linux box from the 2d-engine folder:
+//   g++ -std=c++17 -O2 -pthread -Ilibs -Isrc benchmarks/ProfilerBenchmark.cpp src/Profiler/Profiler.cpp -o profiler-benchmark
+//   ./profiler-benchmark --scopes 100000 --threads 4 --trace profiler-benchmark.json
+/////////////////////////////////////////////////////////////////////////////////
+#include "../src/Profiler/Profiler.h"
+#include <spdlog/spdlog.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+std::atomic<int> sink { 0 };
+
+// Every iteration records two scopes, the outer one and the inner one
+void RecordScopes(int numScopes) {
+	for (int i = 0; i < numScopes / 2; i++) {
+		PROFILE_SCOPE("Outer");
+		{
+			PROFILE_SCOPE("Inner");
+			sink.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+}
+
+double MeasureNsPerScope(int numScopes, int numThreads) {
+	using Clock = std::chrono::steady_clock;
+	auto start = Clock::now();
+	std::vector<std::thread> threads;
+	for (int i = 1; i < numThreads; i++) {
+		threads.emplace_back(RecordScopes, numScopes);
+	}
+	RecordScopes(numScopes);
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	// Without the atomic increment the loop would be optimized away, it is measured apart
+	const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+	return ns / numScopes;
+}
+
+int main(int argc, char* argv[]) {
+	int numScopes = 100000;
+	int numThreads = 4;
+	std::string tracePath;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--scopes" && i + 1 < argc) {
+			numScopes = std::stoi(argv[++i]);
+		}
+		else if (arg == "--threads" && i + 1 < argc) {
+			numThreads = std::max(1, std::stoi(argv[++i]));
+		}
+		else if (arg == "--trace" && i + 1 < argc) {
+			tracePath = argv[++i];
+		}
+		else {
+			std::cerr << "Usage: " << argv[0] << " [--scopes N] [--threads N] [--trace file.json]" << std::endl;
+			return 1;
+		}
+	}
+
+	spdlog::set_level(spdlog::level::warn);
+
+	// Warm up, the buffer of every thread is created the first time it records
+	Profiler::StartCapture();
+	MeasureNsPerScope(1000, numThreads);
+	Profiler::StopCapture();
+
+	const double stoppedNs = MeasureNsPerScope(numScopes, 1);
+	Profiler::StartCapture();
+	const double capturingNs = MeasureNsPerScope(numScopes, 1);
+	Profiler::StopCapture();
+	Profiler::StartCapture();
+	const double threadedNs = MeasureNsPerScope(numScopes, numThreads);
+	Profiler::StopCapture();
+
+	std::cout
+		<< "compiled in=" << PROFILER_ENABLED
+		<< " stopped=" << stoppedNs << "ns/scope"
+		<< " capturing=" << capturingNs << "ns/scope"
+		<< " capturing on " << numThreads << " threads=" << threadedNs << "ns/scope"
+		<< std::endl;
+
+	if (!tracePath.empty() && !Profiler::WriteChromeTrace(tracePath)) {
+		return 1;
+	}
+	return 0;
+}
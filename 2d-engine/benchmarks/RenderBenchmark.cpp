@@ -0,0 +1,197 @@
+/////////////////////////////////////////////////////////////////////////////////
+// Render benchmark
+/////////////////////////////////////////////////////////////////////////////////
+// Headless benchmark of the sprite submission, it renders with the SDL software
+// renderer into an offscreen surface so no window or GPU is needed. The same
+// scene is drawn with one SDL_RenderCopyEx per sprite and with the SpriteBatch.
+//
+// Build and run it on a plain Linux box from the 2d-engine folder:
+//   g++ -std=c++17 -O2 -Ilibs -Isrc $(sdl2-config --cflags) benchmarks/RenderBenchmark.cpp src/Renderer/SpriteBatch.cpp $(sdl2-config --libs) -o render-benchmark
+//   ./render-benchmark --sprites 500,2000,8000 --frames 60 --output render-benchmark.json
+/////////////////////////////////////////////////////////////////////////////////
+#include "../src/Renderer/SpriteBatch.h"
+#include <SDL.h>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+const int TARGET_WIDTH = 800;
+const int TARGET_HEIGHT = 600;
+const int TILE_SIZE = 32;
+
+struct BenchmarkSprite {
+	int texture;
+	SDL_Rect srcRect;
+	SDL_FRect dstRect;
+	double rotation;
+};
+
+struct BenchmarkResult {
+	int numSprites;
+	int numTextures;
+	int numFrames;
+	double copyExMs = 0;
+	double batchMs = 0;
+	int batchDrawCalls = 0;
+};
+
+// A 320x96 tileset like the jungle one, filled with a different color per tile
+SDL_Texture* CreateTilesetTexture(SDL_Renderer* renderer, Uint8 tint) {
+	SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, 10 * TILE_SIZE, 3 * TILE_SIZE, 32, SDL_PIXELFORMAT_RGBA32);
+	for (int row = 0; row < 3; row++) {
+		for (int col = 0; col < 10; col++) {
+			SDL_Rect tile = { col * TILE_SIZE, row * TILE_SIZE, TILE_SIZE, TILE_SIZE };
+			SDL_FillRect(surface, &tile, SDL_MapRGBA(surface->format, tint, col * 25, row * 80, 255));
+		}
+	}
+	SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+	SDL_FreeSurface(surface);
+	return texture;
+}
+
+std::vector<BenchmarkSprite> BuildScene(int numSprites, int numTextures, unsigned int seed) {
+	std::mt19937 random(seed);
+	std::uniform_int_distribution<int> tile(0, 9);
+	std::uniform_int_distribution<int> tileRow(0, 2);
+	std::uniform_real_distribution<float> x(-TILE_SIZE, TARGET_WIDTH);
+	std::uniform_real_distribution<float> y(-TILE_SIZE, TARGET_HEIGHT);
+	std::uniform_real_distribution<double> angle(0.0, 360.0);
+
+	std::vector<BenchmarkSprite> sprites;
+	for (int i = 0; i < numSprites; i++) {
+		BenchmarkSprite sprite;
+		// Long runs of the same texture, like the tiles followed by the units after the z sort
+		sprite.texture = (i * numTextures) / numSprites;
+		sprite.srcRect = { tile(random) * TILE_SIZE, tileRow(random) * TILE_SIZE, TILE_SIZE, TILE_SIZE };
+		sprite.dstRect = { x(random), y(random), static_cast<float>(TILE_SIZE), static_cast<float>(TILE_SIZE) };
+		sprite.rotation = (i % 4 == 0) ? angle(random) : 0.0;
+		sprites.push_back(sprite);
+	}
+	return sprites;
+}
+
+BenchmarkResult RunBenchmark(SDL_Renderer* renderer, const std::vector<SDL_Texture*>& textures, int numSprites, int numFrames, unsigned int seed) {
+	using Clock = std::chrono::steady_clock;
+	const auto sprites = BuildScene(numSprites, static_cast<int>(textures.size()), seed);
+
+	BenchmarkResult result;
+	result.numSprites = numSprites;
+	result.numTextures = static_cast<int>(textures.size());
+	result.numFrames = numFrames;
+
+	for (int frame = 0; frame < numFrames; frame++) {
+		SDL_RenderClear(renderer);
+		auto start = Clock::now();
+		for (const auto& sprite : sprites) {
+			SDL_RenderCopyExF(renderer, textures[sprite.texture], &sprite.srcRect, &sprite.dstRect, sprite.rotation, NULL, SDL_FLIP_NONE);
+		}
+		SDL_RenderPresent(renderer);
+		result.copyExMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	SpriteBatch spriteBatch;
+	for (int frame = 0; frame < numFrames; frame++) {
+		SDL_RenderClear(renderer);
+		auto start = Clock::now();
+		spriteBatch.Begin(renderer);
+		for (const auto& sprite : sprites) {
+			spriteBatch.Draw(textures[sprite.texture], sprite.srcRect, sprite.dstRect, sprite.rotation);
+		}
+		spriteBatch.End();
+		SDL_RenderPresent(renderer);
+		result.batchMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		result.batchDrawCalls = spriteBatch.GetNumDrawCalls();
+	}
+
+	return result;
+}
+
+std::vector<int> ParseIntList(const std::string& text) {
+	std::vector<int> values;
+	std::stringstream stream(text);
+	std::string item;
+	while (std::getline(stream, item, ',')) {
+		values.push_back(std::stoi(item));
+	}
+	return values;
+}
+
+int main(int argc, char* argv[]) {
+	std::vector<int> spriteCounts = { 500, 2000, 8000 };
+	int numFrames = 60;
+	int numTextures = 4;
+	unsigned int seed = 1234;
+	std::string outputPath = "render-benchmark.json";
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--sprites" && i + 1 < argc) {
+			spriteCounts = ParseIntList(argv[++i]);
+		}
+		else if (arg == "--frames" && i + 1 < argc) {
+			numFrames = std::stoi(argv[++i]);
+		}
+		else if (arg == "--textures" && i + 1 < argc) {
+			numTextures = std::max(1, std::stoi(argv[++i]));
+		}
+		else if (arg == "--output" && i + 1 < argc) {
+			outputPath = argv[++i];
+		}
+		else {
+			std::cerr << "Usage: " << argv[0] << " [--sprites 500,2000,...] [--frames N] [--textures N] [--output file.json]" << std::endl;
+			return 1;
+		}
+	}
+
+	// The software renderer draws into a plain surface, SDL video is not initialized at all
+	SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, TARGET_WIDTH, TARGET_HEIGHT, 32, SDL_PIXELFORMAT_RGBA32);
+	SDL_Renderer* renderer = SDL_CreateSoftwareRenderer(target);
+	if (!renderer) {
+		std::cerr << "Error creating the software renderer: " << SDL_GetError() << std::endl;
+		return 1;
+	}
+
+	std::vector<SDL_Texture*> textures;
+	for (int i = 0; i < numTextures; i++) {
+		textures.push_back(CreateTilesetTexture(renderer, static_cast<Uint8>(i * 60)));
+	}
+
+	std::ostringstream json;
+	json << "{\n  \"benchmark\": \"render\",\n  \"renderer\": \"software\",\n  \"results\": [\n";
+	for (size_t i = 0; i < spriteCounts.size(); i++) {
+		BenchmarkResult result = RunBenchmark(renderer, textures, spriteCounts[i], numFrames, seed);
+		const double copyExMsPerFrame = result.copyExMs / result.numFrames;
+		const double batchMsPerFrame = result.batchMs / result.numFrames;
+		std::cout
+			<< "sprites=" << result.numSprites
+			<< " copyEx=" << copyExMsPerFrame << "ms/frame (" << result.numSprites << " draw calls)"
+			<< " batch=" << batchMsPerFrame << "ms/frame (" << result.batchDrawCalls << " draw calls)"
+			<< std::endl;
+		json << "    {\"sprites\": " << result.numSprites
+			<< ", \"textures\": " << result.numTextures
+			<< ", \"frames\": " << result.numFrames
+			<< ", \"copy_ex_ms_per_frame\": " << copyExMsPerFrame
+			<< ", \"copy_ex_draw_calls\": " << result.numSprites
+			<< ", \"batch_ms_per_frame\": " << batchMsPerFrame
+			<< ", \"batch_draw_calls\": " << result.batchDrawCalls
+			<< "}" << (i + 1 < spriteCounts.size() ? "," : "") << "\n";
+	}
+	json << "  ]\n}\n";
+
+	std::ofstream output(outputPath);
+	output << json.str();
+	std::cout << "Results written to " << outputPath << std::endl;
+
+	for (auto texture : textures) {
+		SDL_DestroyTexture(texture);
+	}
+	SDL_DestroyRenderer(renderer);
+	SDL_FreeSurface(target);
+	SDL_Quit();
+
+	return 0;
+}
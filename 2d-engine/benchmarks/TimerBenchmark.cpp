@@ -0,0 +1,148 @@
+/////////////////////////////////////////////////////////////////////////////////
+// Timer benchmark
+/////////////////////////////////////////////////////////////////////////////////
+// Many cooldowns that restart as soon as they end, like the weapons of a big
+// battle. It compares checking the end tick of every cooldown every tick, what
+// a system that compares SDL_GetTicks() per entity does, with the TimerWheel
+// alone and with cooldown events scheduled through the EventBus.
+//
+// Build and run it on a plain Linux box from the 2d-engine folder:
+//   g++ -std=c++17 -O2 -Ilibs -Isrc benchmarks/TimerBenchmark.cpp src/Timing/TimerWheel.cpp src/Profiler/Profiler.cpp src/EventBus/EventRecorder.cpp -o timer-benchmark
+//   ./timer-benchmark --timers 50000 --ticks 3600
+/////////////////////////////////////////////////////////////////////////////////
+#include "../src/Timing/TimerWheel.h"
+#include "../src/EventBus/EventBus.h"
+#include <spdlog/spdlog.h>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+class CooldownEvent: public Event {
+	public:
+		static constexpr int TYPE_ID = 0;
+
+		int cooldown;
+		CooldownEvent(int cooldown): cooldown(cooldown) {}
+};
+
+struct BenchmarkResult {
+	double nsPerTick = 0.0;
+	long long numFired = 0;
+};
+
+using Clock = std::chrono::steady_clock;
+
+// Between half a second and ten seconds at 60 ticks/s
+std::vector<uint32_t> MakeDurations(int numTimers, unsigned int seed) {
+	std::mt19937 random(seed);
+	std::uniform_int_distribution<uint32_t> duration(30, 600);
+	std::vector<uint32_t> durations(numTimers);
+	for (auto& ticks : durations) {
+		ticks = duration(random);
+	}
+	return durations;
+}
+
+BenchmarkResult RunScan(const std::vector<uint32_t>& durations, int numTicks) {
+	BenchmarkResult result;
+	std::vector<uint64_t> endTicks(durations.begin(), durations.end());
+	auto start = Clock::now();
+	for (uint64_t tick = 1; tick <= static_cast<uint64_t>(numTicks); tick++) {
+		for (size_t i = 0; i < endTicks.size(); i++) {
+			if (endTicks[i] == tick) {
+				endTicks[i] = tick + durations[i];
+				result.numFired++;
+			}
+		}
+	}
+	result.nsPerTick = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / numTicks;
+	return result;
+}
+
+BenchmarkResult RunWheel(const std::vector<uint32_t>& durations, int numTicks) {
+	BenchmarkResult result;
+	TimerWheel wheel;
+	for (size_t i = 0; i < durations.size(); i++) {
+		wheel.Schedule(durations[i], durations[i], i);
+	}
+	auto start = Clock::now();
+	for (int tick = 0; tick < numTicks; tick++) {
+		wheel.Advance([&result](const TimerHandle&, uint64_t, bool) {
+			result.numFired++;
+		});
+	}
+	result.nsPerTick = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / numTicks;
+	return result;
+}
+
+struct CooldownCounter {
+	long long numEvents = 0;
+
+	void OnCooldown(CooldownEvent&) {
+		numEvents++;
+	}
+};
+
+BenchmarkResult RunEventBus(const std::vector<uint32_t>& durations, int numTicks) {
+	BenchmarkResult result;
+	EventBus eventBus;
+	CooldownCounter counter;
+	eventBus.SubscribeToEvent<CooldownEvent>(&counter, &CooldownCounter::OnCooldown);
+	for (size_t i = 0; i < durations.size(); i++) {
+		eventBus.ScheduleEvent<CooldownEvent>(durations[i], durations[i], static_cast<int>(i));
+	}
+	auto start = Clock::now();
+	for (int tick = 0; tick < numTicks; tick++) {
+		eventBus.AdvanceTimers();
+	}
+	result.nsPerTick = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / numTicks;
+	result.numFired = counter.numEvents;
+	return result;
+}
+
+int main(int argc, char* argv[]) {
+	int numTimers = 50000;
+	int numTicks = 3600;
+	unsigned int seed = 1234;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--timers" && i + 1 < argc) {
+			numTimers = std::stoi(argv[++i]);
+		}
+		else if (arg == "--ticks" && i + 1 < argc) {
+			numTicks = std::max(1, std::stoi(argv[++i]));
+		}
+		else if (arg == "--seed" && i + 1 < argc) {
+			seed = static_cast<unsigned int>(std::stoul(argv[++i]));
+		}
+		else {
+			std::cerr << "Usage: " << argv[0] << " [--timers N] [--ticks N] [--seed N]" << std::endl;
+			return 1;
+		}
+	}
+
+	spdlog::set_level(spdlog::level::warn);
+
+	const std::vector<uint32_t> durations = MakeDurations(numTimers, seed);
+	const BenchmarkResult scan = RunScan(durations, numTicks);
+	const BenchmarkResult wheel = RunWheel(durations, numTicks);
+	const BenchmarkResult eventBus = RunEventBus(durations, numTicks);
+
+	// The three of them must fire the same cooldowns
+	if (scan.numFired != wheel.numFired || scan.numFired != eventBus.numFired) {
+		std::cerr << "The timers fired differently: scan=" << scan.numFired << " wheel=" << wheel.numFired << " event bus=" << eventBus.numFired << std::endl;
+		return 1;
+	}
+
+	std::cout
+		<< numTimers << " timers, " << numTicks << " ticks, " << scan.numFired / static_cast<double>(numTicks) << " fired/tick"
+		<< " scan=" << scan.nsPerTick << "ns/tick"
+		<< " wheel=" << wheel.nsPerTick << "ns/tick"
+		<< " event bus=" << eventBus.nsPerTick << "ns/tick"
+		<< std::endl;
+	return 0;
+}
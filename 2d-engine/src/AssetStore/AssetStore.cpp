@@ -1,8 +1,72 @@
 #include "AssetStore.h"
+#include "../Threading/ThreadPool.h"
+#include "../Profiler/Profiler.h"
 #include "SDL_image.h"
 #include <spdlog/spdlog.h>
+#include <algorithm>
+#include <mutex>
 
-AssetStore::AssetStore() {
+// imgui_draw.cpp compiles its own static copy of the packer, this one is private to the asset store too
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include <imgui/imstb_rectpack.h>
+
+struct AssetStore::AtlasPage {
+	SDL_Texture* texture = nullptr;
+	int size = 0;
+
+	// Skyline packer state, kept alive so the page can keep receiving images
+	stbrp_context context;
+	std::vector<stbrp_node> nodes;
+};
+
+struct AssetStore::LoadQueue {
+	struct DecodedImage {
+		int textureHandle;
+		int generation;
+		std::string assetId;
+		// Null if the image could not be loaded
+		SDL_Surface* surface;
+	};
+
+	std::mutex mutex;
+	std::vector<DecodedImage> images;
+	// ClearAssets invalidates the handles of the loads still in flight, only the render thread uses it
+	int generation = 0;
+
+	void Clear() {
+		std::lock_guard<std::mutex> lock(mutex);
+		for (auto& image : images) {
+			SDL_FreeSurface(image.surface);
+		}
+		images.clear();
+	}
+
+	~LoadQueue() {
+		Clear();
+	}
+};
+
+// Checkerboard of two colors, easy to spot while the real image is loading
+const int PLACEHOLDER_SIZE = 8;
+
+// Every atlas page uses the same pixel format, so the images are converted when they are decoded
+// It touches no renderer, so the workers can decode at the same time
+static SDL_Surface* DecodeImage(const std::string& filePath) {
+	SDL_Surface* loadedSurface = IMG_Load(filePath.c_str()); // convert to a C string
+	if (!loadedSurface) {
+		spdlog::error("Error loading texture {0}: {1}", filePath, IMG_GetError());
+		return nullptr;
+	}
+	SDL_Surface* surface = SDL_ConvertSurfaceFormat(loadedSurface, SDL_PIXELFORMAT_RGBA32, 0);
+	SDL_FreeSurface(loadedSurface);
+	if (!surface) {
+		spdlog::error("Error converting texture {0}: {1}", filePath, SDL_GetError());
+	}
+	return surface;
+}
+
+AssetStore::AssetStore(): loadQueue(std::make_shared<LoadQueue>()) {
 	spdlog::info("AssetStore constructor called");
 }
 
@@ -12,25 +76,245 @@ AssetStore::~AssetStore() {
 }
 
 void AssetStore::ClearAssets() {
-	for (auto texture : textures) {
-		SDL_DestroyTexture(texture.second);  // get the value of key-value pair
+	for (auto& page : atlasPages) {
+		SDL_DestroyTexture(page->texture);
+	}
+	atlasPages.clear();
+
+	for (auto texture : standaloneTextures) {
+		SDL_DestroyTexture(texture);
 	}
-	textures.clear();
+	standaloneTextures.clear();
+
+	if (placeholderTexture) {
+		SDL_DestroyTexture(placeholderTexture);
+		placeholderTexture = nullptr;
+	}
+
+	textureHandles.clear();
+	textureRegions.clear();
+
+	// The images still being decoded are thrown away when they arrive
+	loadQueue->generation++;
+	loadQueue->Clear();
+	numLoadingTextures = 0;
 }
 
 void AssetStore::AddTexture(SDL_Renderer* renderer, const std::string& assetId, const std::string& filePath)
 {
-	SDL_Surface* surface = IMG_Load(filePath.c_str()); // convert to a C string
-	SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+	SDL_Surface* surface = DecodeImage(filePath);
+	if (!surface) {
+		return;
+	}
+	StoreTexture(renderer, ReserveTextureHandle(assetId), surface);
 	SDL_FreeSurface(surface);
 
-	// Add the texture to the map
-	textures.emplace(assetId, texture);
-
 	spdlog::info("New texture added to the Asset Store with id = {0}", assetId);
 }
 
-SDL_Texture* AssetStore::GetTexture(const std::string& assetId) // const
+int AssetStore::LoadTextureAsync(SDL_Renderer* renderer, const std::string& assetId, const std::string& filePath, ThreadPool& threadPool)
+{
+	// An asset loaded again keeps drawing its old image until the new one is ready
+	const int textureHandle = ReserveTextureHandle(assetId);
+	if (!textureRegions[textureHandle].texture) {
+		textureRegions[textureHandle] = GetPlaceholderRegion(renderer);
+	}
+	numLoadingTextures++;
+
+	auto queue = loadQueue;
+	const int generation = loadQueue->generation;
+	threadPool.Submit([queue, textureHandle, generation, assetId, filePath]() {
+		SDL_Surface* surface = DecodeImage(filePath);
+		std::lock_guard<std::mutex> lock(queue->mutex);
+		queue->images.push_back({ textureHandle, generation, assetId, surface });
+	});
+	return textureHandle;
+}
+
+int AssetStore::UploadLoadedTextures(SDL_Renderer* renderer, int maxUploads)
 {
-	return textures[assetId];  // to acces with brackets the method cant be const
-}
\ No newline at end of file
+	if (numLoadingTextures == 0) {
+		return 0;
+	}
+	PROFILE_SCOPE("AssetStore::UploadLoadedTextures");
+
+	// Taken out of the queue first, the workers do not wait for the uploads
+	std::vector<LoadQueue::DecodedImage> images;
+	{
+		std::lock_guard<std::mutex> lock(loadQueue->mutex);
+		const size_t numImages = std::min(loadQueue->images.size(), static_cast<size_t>(std::max(0, maxUploads)));
+		images.assign(loadQueue->images.begin(), loadQueue->images.begin() + numImages);
+		loadQueue->images.erase(loadQueue->images.begin(), loadQueue->images.begin() + numImages);
+	}
+
+	int numUploads = 0;
+	for (auto& image : images) {
+		if (image.generation != loadQueue->generation) {
+			SDL_FreeSurface(image.surface);
+			continue;
+		}
+		numLoadingTextures--;
+		if (!image.surface) {
+			// Like an asset that was never added, nothing is drawn
+			textureRegions[image.textureHandle] = TextureRegion();
+			continue;
+		}
+		StoreTexture(renderer, image.textureHandle, image.surface);
+		SDL_FreeSurface(image.surface);
+		numUploads++;
+		spdlog::info("New texture added to the Asset Store with id = {0}", image.assetId);
+	}
+	return numUploads;
+}
+
+int AssetStore::ReserveTextureHandle(const std::string& assetId)
+{
+	auto handle = textureHandles.find(assetId);
+	if (handle != textureHandles.end()) {
+		return handle->second;
+	}
+	const int textureHandle = static_cast<int>(textureRegions.size());
+	textureHandles[assetId] = textureHandle;
+	textureRegions.emplace_back();
+	return textureHandle;
+}
+
+void AssetStore::StoreTexture(SDL_Renderer* renderer, int textureHandle, SDL_Surface* surface)
+{
+	TextureRegion region;
+	if (!PackIntoAtlas(renderer, surface, region)) {
+		// Does not fit in a page, give it a texture of its own
+		region.texture = SDL_CreateTextureFromSurface(renderer, surface);
+		region.rect = { 0, 0, surface->w, surface->h };
+		standaloneTextures.push_back(region.texture);
+	}
+
+	// Loading an asset id again replaces its region
+	textureRegions[textureHandle] = region;
+}
+
+TextureRegion AssetStore::GetPlaceholderRegion(SDL_Renderer* renderer)
+{
+	if (!placeholderTexture) {
+		std::vector<Uint8> pixels(PLACEHOLDER_SIZE * PLACEHOLDER_SIZE * 4);
+		for (int row = 0; row < PLACEHOLDER_SIZE; row++) {
+			for (int col = 0; col < PLACEHOLDER_SIZE; col++) {
+				const bool isLight = ((row / (PLACEHOLDER_SIZE / 2)) + (col / (PLACEHOLDER_SIZE / 2))) % 2 == 0;
+				Uint8* pixel = &pixels[(row * PLACEHOLDER_SIZE + col) * 4];
+				pixel[0] = isLight ? 255 : 40;
+				pixel[1] = isLight ? 0 : 40;
+				pixel[2] = isLight ? 255 : 40;
+				pixel[3] = 255;
+			}
+		}
+		placeholderTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, PLACEHOLDER_SIZE, PLACEHOLDER_SIZE);
+		if (placeholderTexture) {
+			SDL_UpdateTexture(placeholderTexture, NULL, pixels.data(), PLACEHOLDER_SIZE * 4);
+		}
+	}
+
+	TextureRegion region;
+	region.texture = placeholderTexture;
+	region.rect = { 0, 0, PLACEHOLDER_SIZE, PLACEHOLDER_SIZE };
+	region.isLoaded = false;
+	return region;
+}
+
+bool AssetStore::PackIntoAtlas(SDL_Renderer* renderer, SDL_Surface* surface, TextureRegion& region) {
+	stbrp_rect rect = {};
+	const int pageSize = GetAtlasPageSize(renderer);
+	if (surface->w + ATLAS_PADDING * 2 > pageSize || surface->h + ATLAS_PADDING * 2 > pageSize) {
+		return false;
+	}
+	rect.w = static_cast<stbrp_coord>(surface->w + ATLAS_PADDING * 2);
+	rect.h = static_cast<stbrp_coord>(surface->h + ATLAS_PADDING * 2);
+
+	// Try the existing pages first, then a brand new one
+	AtlasPage* page = nullptr;
+	for (auto& candidate : atlasPages) {
+		if (stbrp_pack_rects(&candidate->context, &rect, 1)) {
+			page = candidate.get();
+			break;
+		}
+	}
+	if (!page) {
+		page = CreateAtlasPage(renderer, pageSize);
+		if (!page || !stbrp_pack_rects(&page->context, &rect, 1)) {
+			return false;
+		}
+	}
+
+	region.texture = page->texture;
+	region.rect = { rect.x + ATLAS_PADDING, rect.y + ATLAS_PADDING, surface->w, surface->h };
+	SDL_UpdateTexture(page->texture, &region.rect, surface->pixels, surface->pitch);
+	return true;
+}
+
+int AssetStore::GetAtlasPageSize(SDL_Renderer* renderer) const {
+	SDL_RendererInfo info;
+	if (SDL_GetRendererInfo(renderer, &info) == 0 && info.max_texture_width > 0 && info.max_texture_height > 0) {
+		return std::min(ATLAS_PAGE_SIZE, std::min(info.max_texture_width, info.max_texture_height));
+	}
+	return ATLAS_PAGE_SIZE;
+}
+
+AssetStore::AtlasPage* AssetStore::CreateAtlasPage(SDL_Renderer* renderer, int size) {
+	SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, size, size);
+	if (!texture) {
+		spdlog::error("Error creating an atlas page: {0}", SDL_GetError());
+		return nullptr;
+	}
+	SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+	// The padding between the images must be transparent
+	std::vector<Uint32> transparentPixels(static_cast<size_t>(size) * size, 0);
+	SDL_UpdateTexture(texture, NULL, transparentPixels.data(), size * sizeof(Uint32));
+
+	auto page = std::make_unique<AtlasPage>();
+	page->texture = texture;
+	page->size = size;
+	page->nodes.resize(size);
+	stbrp_init_target(&page->context, size, size, page->nodes.data(), static_cast<int>(page->nodes.size()));
+
+	spdlog::info("New atlas page of {0}x{0} created", size);
+
+	atlasPages.push_back(std::move(page));
+	return atlasPages.back().get();
+}
+
+SDL_Texture* AssetStore::GetTexture(const std::string& assetId) const
+{
+	return GetTextureRegion(assetId).texture;
+}
+
+const TextureRegion& AssetStore::GetTextureRegion(const std::string& assetId) const
+{
+	return GetTextureRegion(GetTextureHandle(assetId));
+}
+
+int AssetStore::GetTextureHandle(const std::string& assetId) const
+{
+	auto handle = textureHandles.find(assetId);
+	return handle != textureHandles.end() ? handle->second : INVALID_TEXTURE_HANDLE;
+}
+
+const TextureRegion& AssetStore::GetTextureRegion(int textureHandle) const
+{
+	static const TextureRegion missingRegion;
+	if (textureHandle < 0 || textureHandle >= static_cast<int>(textureRegions.size())) {
+		return missingRegion;
+	}
+	return textureRegions[textureHandle];
+}
+
+int AssetStore::GetNumAtlasPages() const {
+	return static_cast<int>(atlasPages.size());
+}
+
+bool AssetStore::IsTextureLoaded(int textureHandle) const {
+	return GetTextureRegion(textureHandle).isLoaded;
+}
+
+int AssetStore::GetNumLoadingTextures() const {
+	return numLoadingTextures;
+}
@@ -1,18 +1,83 @@
 #pragma once
 #include <map>
+#include <memory>
 #include <SDL.h>
 #include <string>
+#include <vector>
+
+class ThreadPool;
+
+// Where the pixels of a texture asset live: the atlas page that holds it
+// and the rectangle that it occupies inside that page
+struct TextureRegion {
+	SDL_Texture* texture = nullptr;
+	SDL_Rect rect = { 0, 0, 0, 0 };
+	// False while the image is loading, the region is the whole placeholder then
+	bool isLoaded = true;
+};
 
 class AssetStore {
 private:
-	std::map<std::string, SDL_Texture*> textures;
+	// Images are packed into shared atlas pages as they are loaded, so sprites
+	// of different assets can be drawn without switching textures
+	struct AtlasPage;
+	std::vector<std::unique_ptr<AtlasPage>> atlasPages;
+
+	// Images too big for an atlas page keep a texture of their own
+	std::vector<SDL_Texture*> standaloneTextures;
+
+	// A texture asset is identified by its id while loading and by its handle,
+	// the index of its region, while rendering
+	std::map<std::string, int> textureHandles;
+	std::vector<TextureRegion> textureRegions;
+
+	// The images decoded by the workers wait here until the render thread uploads them
+	// The workers share it with the store, so a late image never finds the store gone
+	struct LoadQueue;
+	std::shared_ptr<LoadQueue> loadQueue;
+	int numLoadingTextures = 0;
+	// Drawn instead of the textures that are still loading
+	SDL_Texture* placeholderTexture = nullptr;
+
 	// Create a map for fonts
 	// Create a map for audio
+
+	bool PackIntoAtlas(SDL_Renderer* renderer, SDL_Surface* surface, TextureRegion& region);
+	AtlasPage* CreateAtlasPage(SDL_Renderer* renderer, int size);
+	int GetAtlasPageSize(SDL_Renderer* renderer) const;
+	int ReserveTextureHandle(const std::string& assetId);
+	void StoreTexture(SDL_Renderer* renderer, int textureHandle, SDL_Surface* surface);
+	TextureRegion GetPlaceholderRegion(SDL_Renderer* renderer);
+
 public:
+	// Size of every atlas page, limited by the max texture size of the renderer
+	static constexpr int ATLAS_PAGE_SIZE = 1024;
+	// Empty border around every packed image, avoids bleeding of the neighbours when scaling
+	static constexpr int ATLAS_PADDING = 1;
+
 	AssetStore();
 	~AssetStore();
 
 	void ClearAssets();
 	void AddTexture(SDL_Renderer* renderer, const std::string& assetId, const std::string& filePath);
-	SDL_Texture* GetTexture(const std::string& assetId);
-};
\ No newline at end of file
+
+	// Decodes the image on the thread pool and returns its handle right away, the handle
+	// draws a placeholder until UploadLoadedTextures uploads the image. Call it from the
+	// render thread, before the simulation thread starts looking handles up by asset id
+	int LoadTextureAsync(SDL_Renderer* renderer, const std::string& assetId, const std::string& filePath, ThreadPool& threadPool);
+	// Once per frame on the render thread, uploads up to maxUploads decoded images and returns how many
+	int UploadLoadedTextures(SDL_Renderer* renderer, int maxUploads);
+	bool IsTextureLoaded(int textureHandle) const;
+	// Requested with LoadTextureAsync and not uploaded yet
+	int GetNumLoadingTextures() const;
+
+	// Returns the atlas page that contains the asset, use GetTextureRegion() to find it inside the page
+	SDL_Texture* GetTexture(const std::string& assetId) const;
+	const TextureRegion& GetTextureRegion(const std::string& assetId) const;
+
+	// Handles are stable while the store is not cleared, INVALID_TEXTURE_HANDLE if the asset is unknown
+	static constexpr int INVALID_TEXTURE_HANDLE = -1;
+	int GetTextureHandle(const std::string& assetId) const;
+	const TextureRegion& GetTextureRegion(int textureHandle) const;
+	int GetNumAtlasPages() const;
+};
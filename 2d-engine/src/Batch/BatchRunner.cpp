@@ -0,0 +1,54 @@
+#include "BatchRunner.h"
+#include "../Game/Simulation.h"
+#include <chrono>
+
+BatchRunner::BatchRunner(int numThreads): threadPool(numThreads) {
+}
+
+void BatchRunner::CreateWorlds(int numWorlds, const SetupFunction& setup) {
+	const int firstWorld = static_cast<int>(worlds.size());
+	worlds.resize(firstWorld + numWorlds);
+
+	threadPool.ParallelFor(numWorlds, [&](int index) {
+		auto world = std::make_unique<BatchWorld>();
+		world->registry = std::make_unique<Registry>();
+		world->eventBus = std::make_unique<EventBus>();
+
+		// The subscriptions are kept for the whole run, the event bus is never reset
+		Simulation::AddSystems(*world->registry);
+		Simulation::SubscribeToEvents(*world->registry, world->eventBus);
+		setup(firstWorld + index, *world->registry, world->eventBus);
+
+		worlds[firstWorld + index] = std::move(world);
+	});
+}
+
+BatchRunner::BatchResult BatchRunner::Run(int numTicks, double deltaTime) {
+	using Clock = std::chrono::steady_clock;
+	const auto start = Clock::now();
+
+	// A task per world, the steps of a world always run in order on the same thread
+	threadPool.ParallelFor(static_cast<int>(worlds.size()), [&](int index) {
+		BatchWorld& world = *worlds[index];
+		for (int tick = 0; tick < numTicks; tick++) {
+			Simulation::Update(*world.registry, world.eventBus, deltaTime);
+		}
+		world.numTicks += numTicks;
+	});
+
+	BatchResult result;
+	result.numWorlds = static_cast<int>(worlds.size());
+	result.numThreads = threadPool.GetNumThreads();
+	result.numTicks = numTicks;
+	result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	result.worldTicksPerSecond = result.seconds > 0.0 ? static_cast<double>(result.numWorlds) * numTicks / result.seconds : 0.0;
+	return result;
+}
+
+int BatchRunner::GetNumWorlds() const {
+	return static_cast<int>(worlds.size());
+}
+
+const BatchWorld& BatchRunner::GetWorld(int worldIndex) const {
+	return *worlds[worldIndex];
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <vector>
+#include "../ECS/ECS.h"
+#include "../EventBus/EventBus.h"
+#include "../Threading/ThreadPool.h"
+
+// A world of the batch, it shares nothing writable with the others
+struct BatchWorld {
+	std::unique_ptr<Registry> registry;
+	std::unique_ptr<EventBus> eventBus;
+	long long numTicks = 0;
+};
+
+/////////////////////////////////////////////////////////////////////////////////
+// BatchRunner
+/////////////////////////////////////////////////////////////////////////////////
+// Hosts many independent worlds, each one with its own Registry and EventBus,
+// and steps them in parallel on a thread pool. The worlds are never drawn and
+// can only share read-only data, like a tilemap and its collision layer.
+/////////////////////////////////////////////////////////////////////////////////
+class BatchRunner {
+public:
+	// Adds the entities of a world, the systems of the Simulation are already added and subscribed
+	using SetupFunction = std::function<void(int worldIndex, Registry& registry, std::unique_ptr<EventBus>& eventBus)>;
+
+	struct BatchResult {
+		int numWorlds = 0;
+		int numThreads = 0;
+		int numTicks = 0;
+		double seconds = 0.0;
+		double worldTicksPerSecond = 0.0;
+	};
+
+private:
+	ThreadPool threadPool;
+	std::vector<std::unique_ptr<BatchWorld>> worlds;
+
+public:
+	// 0 threads uses one per hardware thread
+	explicit BatchRunner(int numThreads = 0);
+
+	// The worlds are created in parallel too
+	void CreateWorlds(int numWorlds, const SetupFunction& setup);
+
+	// Every world runs numTicks steps of deltaTime seconds, call it with 1 tick to keep the worlds in lockstep
+	BatchResult Run(int numTicks, double deltaTime);
+
+	int GetNumWorlds() const;
+	const BatchWorld& GetWorld(int worldIndex) const;
+};
@@ -0,0 +1,86 @@
+#pragma once
+#include <SDL.h>
+#include <glm/glm.hpp>
+
+/////////////////////////////////////////////////////////////////////////////////
+// Camera
+/////////////////////////////////////////////////////////////////////////////////
+// The part of the world that is visible in the window. Everything in the world
+// is rendered at its world position minus the camera position.
+/////////////////////////////////////////////////////////////////////////////////
+class Camera {
+private:
+	// Top left corner of the view in world coordinates
+	glm::vec2 position = glm::vec2(0.0f);
+	int viewportWidth = 0;
+	int viewportHeight = 0;
+
+	// Size of the world the camera is kept inside of, zero means unbounded
+	glm::vec2 worldSize = glm::vec2(0.0f);
+
+	void ClampToWorld() {
+		if (worldSize.x > 0) {
+			position.x = glm::clamp(position.x, 0.0f, glm::max(0.0f, worldSize.x - viewportWidth));
+		}
+		if (worldSize.y > 0) {
+			position.y = glm::clamp(position.y, 0.0f, glm::max(0.0f, worldSize.y - viewportHeight));
+		}
+	}
+
+public:
+	Camera(int viewportWidth = 0, int viewportHeight = 0) {
+		this->viewportWidth = viewportWidth;
+		this->viewportHeight = viewportHeight;
+	}
+
+	void SetViewportSize(int width, int height) {
+		viewportWidth = width;
+		viewportHeight = height;
+		ClampToWorld();
+	}
+
+	void SetWorldSize(glm::vec2 size) {
+		worldSize = size;
+		ClampToWorld();
+	}
+
+	void SetPosition(glm::vec2 position) {
+		this->position = position;
+		ClampToWorld();
+	}
+
+	// Move the camera so the world point ends up in the center of the viewport
+	void CenterOn(glm::vec2 worldPoint) {
+		SetPosition(worldPoint - glm::vec2(viewportWidth, viewportHeight) * 0.5f);
+	}
+
+	glm::vec2 GetPosition() const {
+		return position;
+	}
+
+	int GetViewportWidth() const {
+		return viewportWidth;
+	}
+
+	int GetViewportHeight() const {
+		return viewportHeight;
+	}
+
+	glm::vec2 WorldToScreen(glm::vec2 worldPoint) const {
+		return worldPoint - position;
+	}
+
+	glm::vec2 ScreenToWorld(glm::vec2 screenPoint) const {
+		return screenPoint + position;
+	}
+
+	// Visible area in world coordinates
+	SDL_FRect GetViewRect() const {
+		return { position.x, position.y, static_cast<float>(viewportWidth), static_cast<float>(viewportHeight) };
+	}
+
+	// Visible area in screen coordinates
+	SDL_FRect GetScreenRect() const {
+		return { 0.0f, 0.0f, static_cast<float>(viewportWidth), static_cast<float>(viewportHeight) };
+	}
+};
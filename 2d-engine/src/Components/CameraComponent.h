@@ -0,0 +1,12 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// The camera follows the entity that has this component
+struct CameraComponent {
+    glm::vec2 offset;
+
+    CameraComponent(glm::vec2 offset = glm::vec2(0.0, 0.0)) {
+        this->offset = offset;
+    }
+};
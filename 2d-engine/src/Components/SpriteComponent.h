@@ -1,19 +1,49 @@
 #pragma once
 #include <string>
+#include <vector>
 #include <glm/glm.hpp>
+#include <SDL.h>
 
 struct SpriteComponent {
     std::string assetId;
+    // Handle of the assetId in the AssetStore, resolved by the RenderSystem the first time the sprite is drawn
+    int textureHandle;
     int width;
     int height;
     int zIndex;
     SDL_Rect srcRect;
+    bool isFixed; // drawn in screen coordinates, it does not move with the camera
 
-    SpriteComponent(std::string assetId = "", int width = 0, int height = 0, int zIndex = 0,  int srcRectX = 0, int srcRectY = 0) {
+    // Set by the RenderSystem when it adds the entity, SetZIndex queues the entity id there
+    std::vector<int>* zIndexChanges;
+    int entityId;
+
+    SpriteComponent(std::string assetId = "", int width = 0, int height = 0, int zIndex = 0,  int srcRectX = 0, int srcRectY = 0, bool isFixed = false) {
         this->assetId = assetId;
+        this->textureHandle = -1;
         this->width = width;
         this->height = height;
         this->zIndex = zIndex;
         this->srcRect = { srcRectX, srcRectY, width, height };
+        this->isFixed = isFixed;
+        this->zIndexChanges = nullptr;
+        this->entityId = -1;
+    }
+
+    // Change the z-index through here, the RenderSystem moves only the queued entities to their new bucket
+    void SetZIndex(int zIndex) {
+        if (zIndex == this->zIndex) {
+            return;
+        }
+        this->zIndex = zIndex;
+        if (zIndexChanges) {
+            zIndexChanges->push_back(entityId);
+        }
+    }
+
+    // Change the image through here, the handle of the new asset id is resolved again
+    void SetAssetId(const std::string& assetId) {
+        this->assetId = assetId;
+        this->textureHandle = -1;
     }
 };
@@ -0,0 +1,10 @@
+#pragma once
+
+// The entity was spawned by a chunk of a streamed world, it is killed when the chunk is evicted
+struct StreamedComponent {
+    int chunkIndex;
+
+    StreamedComponent(int chunkIndex = -1) {
+        this->chunkIndex = chunkIndex;
+    }
+};
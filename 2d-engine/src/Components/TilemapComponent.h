@@ -0,0 +1,17 @@
+#pragma once
+
+#include <memory>
+#include "../Tilemap/Tilemap.h"
+#include "../Tilemap/TileCollisionLayer.h"
+
+// A whole tilemap in a single entity: the tile ids and which of them are solid
+// The data is shared, copying the component does not copy the tiles
+struct TilemapComponent {
+    std::shared_ptr<Tilemap> tilemap;
+    std::shared_ptr<TileCollisionLayer> collisionLayer;
+
+    TilemapComponent(std::shared_ptr<Tilemap> tilemap = nullptr, std::shared_ptr<TileCollisionLayer> collisionLayer = nullptr) {
+        this->tilemap = tilemap;
+        this->collisionLayer = collisionLayer;
+    }
+};
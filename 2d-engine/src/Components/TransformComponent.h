@@ -7,9 +7,15 @@ struct TransformComponent {
 	glm::vec2 scale;
 	double rotation;
 
+	// State at the start of the current simulation step, the renderer draws in between
+	glm::vec2 previousPosition;
+	double previousRotation;
+
 	TransformComponent(glm::vec2 position=glm::vec2(0.0,0.0), glm::vec2 scale=glm::vec2(1.0, 1.0), double rotation=0.0) {
 		this->position = position; // this indicate the self class 
 		this->scale = scale;
 		this->rotation = rotation;
+		this->previousPosition = position;
+		this->previousRotation = rotation;
 	}
 };
\ No newline at end of file
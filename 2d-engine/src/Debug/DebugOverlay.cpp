@@ -0,0 +1,167 @@
+#include "DebugOverlay.h"
+#include <imgui/imgui.h>
+#include <imgui/imgui_sdl.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+// typeid names are "class Name" with MSVC and the mangled "4Name" with GCC and Clang
+static const char* GetReadableTypeName(const char* name) {
+	if (std::strncmp(name, "class ", 6) == 0) {
+		return name + 6;
+	}
+	if (std::strncmp(name, "struct ", 7) == 0) {
+		return name + 7;
+	}
+	while (*name >= '0' && *name <= '9') {
+		name++;
+	}
+	return name;
+}
+
+void DebugOverlay::Initialize(SDL_Renderer* renderer, int windowWidth, int windowHeight) {
+	this->renderer = renderer;
+	ImGui::CreateContext();
+	// Do not save the window positions into an imgui.ini next to the game
+	ImGui::GetIO().IniFilename = NULL;
+	ImGuiSDL::Initialize(renderer, windowWidth, windowHeight);
+
+	stepTimes.assign(HISTORY_SIZE, 0.0f);
+	previousFrameTime = std::chrono::steady_clock::now();
+}
+
+void DebugOverlay::Destroy() {
+	if (!renderer) {
+		return;
+	}
+	ImGuiSDL::Deinitialize();
+	ImGui::DestroyContext();
+	renderer = nullptr;
+}
+
+void DebugOverlay::ProcessEvent(const SDL_Event& sdlEvent) {
+	if (sdlEvent.type == SDL_MOUSEWHEEL) {
+		mouseWheel += static_cast<float>(sdlEvent.wheel.y);
+	}
+}
+
+void DebugOverlay::RenderTimings(const char* label, const std::vector<Profiler::ScopeTiming>& timings, double nanosecondsPerTick, int numSteps) {
+	if (!ImGui::CollapsingHeader(label, ImGuiTreeNodeFlags_DefaultOpen)) {
+		return;
+	}
+	// The scopes are nested, the time of a scope includes the scopes inside it
+	ImGui::Columns(3, label);
+	ImGui::Text("Scope"); ImGui::NextColumn();
+	ImGui::Text("ms"); ImGui::NextColumn();
+	ImGui::Text("Calls"); ImGui::NextColumn();
+	ImGui::Separator();
+	const int divisor = std::max(1, numSteps);
+	for (const auto& timing : timings) {
+		ImGui::Text("%s", timing.name); ImGui::NextColumn();
+		ImGui::Text("%.3f", timing.ticks * nanosecondsPerTick / 1000000.0 / divisor); ImGui::NextColumn();
+		ImGui::Text("%d", timing.count / divisor); ImGui::NextColumn();
+	}
+	ImGui::Columns(1);
+}
+
+void DebugOverlay::Render(const DebugStats& stats, bool isNewSnapshot, const FramePacer& framePacer, const SnapshotRenderer& snapshotRenderer) {
+	PROFILE_SCOPE("DebugOverlay::Render");
+	const double nanosecondsPerTick = Profiler::GetNanosecondsPerTick();
+
+	// The time of the simulation step is the time of Game::Update
+	if (isNewSnapshot && stats.numSteps > 0) {
+		for (const auto& timing : stats.timings) {
+			if (std::strcmp(timing.name, "Game::Update") == 0) {
+				stepTimes[nextStepTimeIndex] = static_cast<float>(timing.ticks * stats.nanosecondsPerTick / 1000000.0 / stats.numSteps);
+				nextStepTimeIndex = (nextStepTimeIndex + 1) % HISTORY_SIZE;
+			}
+		}
+	}
+	Profiler::TakeThreadTimings(renderTimings);
+
+	// The platform input that imgui_sdl leaves to the application
+	ImGuiIO& io = ImGui::GetIO();
+	const auto now = std::chrono::steady_clock::now();
+	io.DeltaTime = std::max(0.0001f, std::chrono::duration<float>(now - previousFrameTime).count());
+	previousFrameTime = now;
+
+	int outputWidth, outputHeight;
+	SDL_GetRendererOutputSize(renderer, &outputWidth, &outputHeight);
+	io.DisplaySize = ImVec2(static_cast<float>(outputWidth), static_cast<float>(outputHeight));
+
+	int mouseX, mouseY;
+	const Uint32 buttons = SDL_GetMouseState(&mouseX, &mouseY);
+	io.MousePos = ImVec2(static_cast<float>(mouseX), static_cast<float>(mouseY));
+	io.MouseDown[0] = (buttons & SDL_BUTTON(SDL_BUTTON_LEFT)) != 0;
+	io.MouseDown[1] = (buttons & SDL_BUTTON(SDL_BUTTON_RIGHT)) != 0;
+	io.MouseWheel = mouseWheel;
+	mouseWheel = 0.0f;
+
+	ImGui::NewFrame();
+	ImGui::SetNextWindowPos(ImVec2(10, 10), ImGuiCond_FirstUseEver);
+	ImGui::SetNextWindowSize(ImVec2(360, 480), ImGuiCond_FirstUseEver);
+	ImGui::SetNextWindowBgAlpha(0.85f);
+	if (ImGui::Begin("Debug")) {
+		if (ImGui::CollapsingHeader("Frames", ImGuiTreeNodeFlags_DefaultOpen)) {
+			char overlayText[64];
+
+			framePacer.GetFrameTimeHistory(frameTimes);
+			const FramePacer::FrameStats frameStats = framePacer.GetStats();
+			const float lastFrameTime = frameTimes.empty() ? 0.0f : frameTimes.back();
+			snprintf(overlayText, sizeof(overlayText), "%.2f ms", lastFrameTime);
+			ImGui::PlotLines("Frame", frameTimes.data(), static_cast<int>(frameTimes.size()), 0, overlayText, 0.0f, 50.0f, ImVec2(0, 60));
+			ImGui::Text("Mean %.2f ms, p99 %.2f ms, max %.2f ms, %d late", frameStats.meanMs, frameStats.p99Ms, frameStats.maxMs, frameStats.numLateFrames);
+
+			const int lastStepIndex = (nextStepTimeIndex + HISTORY_SIZE - 1) % HISTORY_SIZE;
+			snprintf(overlayText, sizeof(overlayText), "%.2f ms", stepTimes[lastStepIndex]);
+			ImGui::PlotLines("Step", stepTimes.data(), HISTORY_SIZE, nextStepTimeIndex, overlayText, 0.0f, 20.0f, ImVec2(0, 60));
+			ImGui::Text("%d steps in the last snapshot", stats.numSteps);
+
+			ImGui::Text("%d draw calls, %d sprites, %d chunks", snapshotRenderer.GetNumDrawCalls(), snapshotRenderer.GetNumSprites(), snapshotRenderer.GetNumChunksDrawn());
+		}
+
+		RenderTimings("Simulation scopes per step", stats.timings, stats.nanosecondsPerTick, stats.numSteps);
+		RenderTimings("Render scopes per frame", renderTimings, nanosecondsPerTick, 1);
+
+		if (ImGui::CollapsingHeader("Systems", ImGuiTreeNodeFlags_DefaultOpen)) {
+			ImGui::Text("%d entities alive", stats.numEntities);
+			ImGui::Columns(2, "Systems");
+			for (const auto& system : stats.systems) {
+				ImGui::Text("%s", GetReadableTypeName(system.name)); ImGui::NextColumn();
+				ImGui::Text("%d", system.numEntities); ImGui::NextColumn();
+			}
+			ImGui::Columns(1);
+		}
+
+		if (ImGui::CollapsingHeader("Component pools")) {
+			ImGui::Columns(3, "Component pools");
+			ImGui::Text("Component"); ImGui::NextColumn();
+			ImGui::Text("Used / size"); ImGui::NextColumn();
+			ImGui::Text("KB"); ImGui::NextColumn();
+			ImGui::Separator();
+			for (const auto& pool : stats.pools) {
+				ImGui::Text("%s", GetReadableTypeName(pool.name)); ImGui::NextColumn();
+				ImGui::Text("%d / %d", pool.numComponents, pool.size); ImGui::NextColumn();
+				ImGui::Text("%.1f", pool.memoryBytes / 1024.0); ImGui::NextColumn();
+			}
+			ImGui::Columns(1);
+		}
+
+		if (ImGui::CollapsingHeader("Events")) {
+			ImGui::Columns(2, "Events");
+			for (const auto& event : stats.events) {
+				ImGui::Text("%s", GetReadableTypeName(event.name)); ImGui::NextColumn();
+				ImGui::Text("%d", event.numEmitted); ImGui::NextColumn();
+			}
+			ImGui::Columns(1);
+		}
+
+		if (ImGui::CollapsingHeader("Collisions", ImGuiTreeNodeFlags_DefaultOpen)) {
+			ImGui::Text("%zu candidate pairs, %zu collisions", stats.numCandidatePairs, stats.numCollisions);
+		}
+	}
+	ImGui::End();
+
+	ImGui::Render();
+	ImGuiSDL::Render(ImGui::GetDrawData());
+}
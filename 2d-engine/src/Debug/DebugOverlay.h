@@ -0,0 +1,49 @@
+#pragma once
+#include <SDL.h>
+#include <chrono>
+#include <vector>
+#include "DebugStats.h"
+#include "../Profiler/Profiler.h"
+#include "../Renderer/SnapshotRenderer.h"
+#include "../Timing/FramePacer.h"
+
+/////////////////////////////////////////////////////////////////////////////////
+// DebugOverlay
+/////////////////////////////////////////////////////////////////////////////////
+// Dear ImGui window drawn over the game on the render thread. It shows the
+// frame time graphs, the time of every profiled scope, the entities of every
+// system, the component pools, the events emitted and the collision pairs.
+// ImGui is drawn with imgui_sdl through the SDL renderer, so it also works
+// with the software renderer.
+/////////////////////////////////////////////////////////////////////////////////
+class DebugOverlay {
+private:
+	SDL_Renderer* renderer = nullptr;
+	std::chrono::steady_clock::time_point previousFrameTime;
+	float mouseWheel = 0.0f;
+
+	std::vector<float> frameTimes;
+	// Milliseconds per simulation step, a ring of HISTORY_SIZE values
+	std::vector<float> stepTimes;
+	int nextStepTimeIndex = 0;
+
+	// Scopes of the render thread since the previous frame
+	std::vector<Profiler::ScopeTiming> renderTimings;
+
+	void RenderTimings(const char* label, const std::vector<Profiler::ScopeTiming>& timings, double nanosecondsPerTick, int numSteps);
+
+public:
+	static constexpr int HISTORY_SIZE = 240;
+
+	DebugOverlay() = default;
+
+	void Initialize(SDL_Renderer* renderer, int windowWidth, int windowHeight);
+	// Must be called before the renderer is destroyed
+	void Destroy();
+
+	// Passes the mouse wheel to ImGui
+	void ProcessEvent(const SDL_Event& sdlEvent);
+
+	// isNewSnapshot adds the simulation steps of the stats to the graph
+	void Render(const DebugStats& stats, bool isNewSnapshot, const FramePacer& framePacer, const SnapshotRenderer& snapshotRenderer);
+};
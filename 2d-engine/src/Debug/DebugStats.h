@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "../Profiler/Profiler.h"
+
+/////////////////////////////////////////////////////////////////////////////////
+// DebugStats
+/////////////////////////////////////////////////////////////////////////////////
+// Statistics of the simulation shown by the debug overlay. The simulation
+// thread fills them into the render snapshot only while the overlay is
+// visible, so the render thread never reads the registry or the event bus.
+// The names come from typeid and live as long as the program.
+/////////////////////////////////////////////////////////////////////////////////
+struct DebugStats {
+	struct SystemStats {
+		const char* name;
+		int numEntities;
+	};
+
+	struct PoolStats {
+		const char* name;
+		// Components turned on and slots of the pool
+		int numComponents;
+		int size;
+		size_t memoryBytes;
+	};
+
+	struct EventStats {
+		const char* name;
+		int numEmitted;
+	};
+
+	// Time of the scopes of the simulation thread since the previous snapshot
+	std::vector<Profiler::ScopeTiming> timings;
+	double nanosecondsPerTick = 1.0;
+	int numSteps = 0;
+
+	int numEntities = 0;
+	std::vector<SystemStats> systems;
+	std::vector<PoolStats> pools;
+	// Events emitted since the previous snapshot
+	std::vector<EventStats> events;
+
+	// Of the last step
+	size_t numCandidatePairs = 0;
+	size_t numCollisions = 0;
+
+	void Clear() {
+		timings.clear();
+		numSteps = 0;
+		numEntities = 0;
+		systems.clear();
+		pools.clear();
+		events.clear();
+		numCandidatePairs = 0;
+		numCollisions = 0;
+	}
+};
@@ -1,7 +1,9 @@
 #include "ECS.h"
+#include "../Profiler/Profiler.h"
+#include <algorithm>
 
 // We need to assign an initial value for the static nextId atribute
-int IComponent::nextId = 0;
+std::atomic<int> IComponent::nextId { 0 };
 
 int Entity::GetId() const {
 	return id;
@@ -13,23 +15,27 @@ void Entity::Kill() {
 
 void System::AddEntityToSystem(Entity entity){
 	entities.push_back(entity);
+	OnEntityAdded(entity);
 }
 
 void System::RemoveEntityFromSystem(Entity entity) {
 	// Could use a for instead...
-	entities.erase(
-		std::remove_if(
-			entities.begin(),
-			entities.end(),
-			[&entity](Entity other) {
-				return entity == other; // this operator is overloaded
-			}
-		), 
-		entities.end()
+	auto removed = std::remove_if(
+		entities.begin(),
+		entities.end(),
+		[&entity](Entity other) {
+			return entity == other; // this operator is overloaded
+		}
 	);
+
+	// The registry asks every system, only notify the ones that really had the entity
+	if (removed != entities.end()) {
+		entities.erase(removed, entities.end());
+		OnEntityRemoved(entity);
+	}
 }
 
-std::vector<Entity> System::GetSystemEntities() const {
+const std::vector<Entity>& System::GetSystemEntities() const {
 	return entities;
 }
 
@@ -98,6 +104,8 @@ void Registry::RemoveEntityFromSystems(Entity entity) {
 }
 
 void Registry::Update() {
+	PROFILE_SCOPE("Registry::Update");
+
 	// Add the entities that are waiting to be created to the active Systems
 	for (auto entity : entitiesToBeAdded) {
 		AddEntityToSystems(entity);
@@ -113,4 +121,18 @@ void Registry::Update() {
 		freeIds.push_back(entity.GetId());
 	}
 	entitiesToBeKilled.clear();
-}
\ No newline at end of file
+}
+
+int Registry::GetNumAliveEntities() const {
+	return numEntities - static_cast<int>(freeIds.size());
+}
+
+int Registry::GetNumEntitiesWithComponent(int componentId) const {
+	int count = 0;
+	for (const auto& signature : entityComponentSignatures) {
+		if (signature.test(componentId)) {
+			count++;
+		}
+	}
+	return count;
+}
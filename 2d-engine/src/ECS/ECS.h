@@ -1,4 +1,5 @@
 #pragma once
+#include <atomic>
 #include <bitset>
 #include <vector>
 #include <unordered_map>
@@ -24,7 +25,8 @@ typedef std::bitset<MAX_COMPONENTS> Signature;
 // Inheritance help us to manage that different classes used as TComponent
 struct IComponent {
 protected:
-	static int nextId;
+	// Atomic because registries on different threads can meet a new component type at the same time
+	static std::atomic<int> nextId;
 };
 
 // Used to assign an unique id to a component type
@@ -72,13 +74,20 @@ class System {
 private:
 	Signature componentSignature;
 	std::vector<Entity> entities;
+
+protected:
+	// Hooks for the systems that keep their own structures about their entities
+	// They are called once the entity has been added or removed from the system
+	virtual void OnEntityAdded(Entity) {}
+	virtual void OnEntityRemoved(Entity) {}
+
 public:
 	System() = default; 
 	virtual ~System() = default;
 
 	void AddEntityToSystem(Entity entity);
 	void RemoveEntityFromSystem(Entity entity);
-	std::vector<Entity> GetSystemEntities() const;
+	const std::vector<Entity>& GetSystemEntities() const;
 	const Signature& GetComponentSignature() const;
 
 	// Define the component type T that entities must have to be considered by the system
@@ -94,6 +103,11 @@ public:
 class IPool {
 public:
 	virtual ~IPool() {}
+
+	// Statistics for the debug overlay
+	virtual const char* GetComponentName() const = 0;
+	virtual int GetSize() const = 0;
+	virtual size_t GetMemoryUsage() const = 0;
 };
 
 template <typename T>
@@ -112,10 +126,18 @@ public:
 		return data.empty();
 	}
 
-	int GetSize() const {
+	int GetSize() const override {
 		return data.size();
 	}
 
+	const char* GetComponentName() const override {
+		return typeid(T).name();
+	}
+
+	size_t GetMemoryUsage() const override {
+		return data.capacity() * sizeof(T);
+	}
+
 	void Resize(int n) {
 		data.resize(n);
 	}
@@ -212,6 +234,17 @@ public:
 	// Check the component signature of an entity and add/remove the entity to the systems
 	void AddEntityToSystems(Entity entity);
 	void RemoveEntityFromSystems(Entity entity);
+
+	/////////////////////////////////////////////////////////////////////////////////
+	// Statistics for the debug overlay
+	/////////////////////////////////////////////////////////////////////////////////
+	int GetNumAliveEntities() const;
+	// Entities that have the component turned on in their signature
+	int GetNumEntitiesWithComponent(int componentId) const;
+	// The function receives the type name of the system and the system
+	template <typename TFunction> void ForEachSystem(TFunction function) const;
+	// The function receives the component id and its pool
+	template <typename TFunction> void ForEachComponentPool(TFunction function) const;
 };
 
 /////////////////////////////////////////////////////////////////////////////////
@@ -282,6 +315,22 @@ TSystem& Registry::GetSystem() const {
 	return *(std::static_pointer_cast<TSystem>(system->second));
 }
 
+template <typename TFunction>
+void Registry::ForEachSystem(TFunction function) const {
+	for (const auto& system : systems) {
+		function(system.first.name(), *system.second);
+	}
+}
+
+template <typename TFunction>
+void Registry::ForEachComponentPool(TFunction function) const {
+	for (size_t componentId = 0; componentId < componentPools.size(); componentId++) {
+		if (componentPools[componentId]) {
+			function(static_cast<int>(componentId), *componentPools[componentId]);
+		}
+	}
+}
+
 template <typename TComponent, typename ...TArgs>
 void Registry::AddComponent(Entity entity, TArgs&& ...args) {
 	const auto componentId = Component<TComponent>::GetId();
@@ -1,6 +1,18 @@
 #pragma once
 
 class Event {
+    private:
+        bool isConsumed = false;
+
     public:
         Event() = default;
-};
\ No newline at end of file
+
+        // Stops the dispatch of the event, the handlers of lower priority do not receive it
+        void Consume() {
+            isConsumed = true;
+        }
+
+        bool IsConsumed() const {
+            return isConsumed;
+        }
+};
@@ -1,54 +1,271 @@
 #pragma once
 
 #include "Event.h"
-#include <map>
+#include "EventDelegate.h"
+#include "EventRecorder.h"
+#include "../Profiler/Profiler.h"
+#include "../Timing/TimerWheel.h"
+#include <algorithm>
+#include <array>
 #include <memory>
-#include <typeindex>
-#include <functional>
-#include <list>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
 #include <spdlog/spdlog.h>
 
-class IEventCallback {
+const unsigned int MAX_EVENT_TYPES = 32;
+
+// The handlers of higher priority receive the events first, the ones with the same priority in subscription order
+const int DEFAULT_EVENT_PRIORITY = 0;
+
+// A handler and the id used to unsubscribe it, 0 once it has been unsubscribed
+struct EventHandler {
+    int id;
+    int priority;
+    EventDelegate delegate;
+};
+
+typedef std::vector<EventHandler> HandlerList;
+
+// Returned by SubscribeToEvent, identifies the subscription to unsubscribe it
+struct EventSubscription {
+    int eventTypeId = -1;
+    int id = 0;
+
+    bool IsValid() const {
+        return id != 0;
+    }
+};
+
+// The events of a batch handler, contiguous and all of the same type
+template <typename TEvent>
+class EventSpan {
     private:
-        virtual void Call(Event& e) = 0;
+        TEvent* events;
+        size_t numEvents;
 
     public:
-        virtual ~IEventCallback() = default;
-        
-        void Execute(Event& e) {
-            Call(e);
-        }
+        EventSpan(TEvent* events, size_t numEvents): events(events), numEvents(numEvents) {}
+
+        TEvent* begin() const { return events; }
+        TEvent* end() const { return events + numEvents; }
+        size_t size() const { return numEvents; }
+        bool empty() const { return numEvents == 0; }
+        TEvent& operator [](size_t index) const { return events[index]; }
 };
 
-template <typename TOwner, typename TEvent>
-class EventCallback: public IEventCallback {
-    private:
-        typedef void (TOwner::*CallbackFunction)(TEvent&);
+// The queue of an event type in queued mode
+class IEventQueue {
+    public:
+        // A handler can not dispatch the queue that is handing it its events
+        bool isDispatching = false;
+
+        virtual ~IEventQueue() = default;
+
+        // Moves the queued events into a batch that stays valid until the next TakeBatch
+        virtual EventBatch TakeBatch() = 0;
+        virtual size_t GetSize() const = 0;
+        virtual void SetNumLanes(int numLanes) = 0;
+};
+
+template <typename TEvent>
+class EventQueue: public IEventQueue {
+    public:
+        // Events of a lane, each one on its own cache line so the producers do not share them
+        struct alignas(64) Lane {
+            std::vector<TEvent> events;
+        };
 
-        TOwner* ownerInstance;
-        CallbackFunction callbackFunction;
+        std::vector<TEvent> events;
+        std::vector<Lane> lanes;
+        // The events being dispatched, handlers can queue new ones meanwhile
+        std::vector<TEvent> dispatchingEvents;
 
-        virtual void Call(Event& e) override {
-            std::invoke(callbackFunction, ownerInstance, static_cast<TEvent&>(e));
+        // The events emitted directly go first, then the lanes in order
+        EventBatch TakeBatch() override {
+            dispatchingEvents.clear();
+            dispatchingEvents.swap(events);
+            for (auto& lane : lanes) {
+                dispatchingEvents.insert(dispatchingEvents.end(), lane.events.begin(), lane.events.end());
+                lane.events.clear();
+            }
+            return { dispatchingEvents.data(), dispatchingEvents.size() };
         }
 
+        size_t GetSize() const override {
+            size_t size = events.size();
+            for (const auto& lane : lanes) {
+                size += lane.events.size();
+            }
+            return size;
+        }
+
+        void SetNumLanes(int numLanes) override {
+            lanes.resize(numLanes);
+        }
+};
+
+// The events scheduled to be emitted later, kept until their timer fires for the last time
+class IScheduledEvents {
+    public:
+        virtual ~IScheduledEvents() = default;
+        virtual void Release(int index) = 0;
+};
+
+template <typename TEvent>
+class ScheduledEvents: public IScheduledEvents {
     public:
-        EventCallback(TOwner* ownerInstance, CallbackFunction callbackFunction) {
-            this->ownerInstance = ownerInstance;
-            this->callbackFunction = callbackFunction;
+        std::vector<TEvent> events;
+        std::vector<int> freeIndices;
+
+        int Add(const TEvent& event) {
+            if (freeIndices.empty()) {
+                events.push_back(event);
+                return static_cast<int>(events.size()) - 1;
+            }
+            const int index = freeIndices.back();
+            freeIndices.pop_back();
+            events[index] = event;
+            return index;
+        }
+
+        void Release(int index) override {
+            freeIndices.push_back(index);
         }
-    
-        virtual ~EventCallback() override = default;
 };
 
-typedef std::list<std::unique_ptr<IEventCallback>> HandlerList;
+class ScopedSubscription;
 
 class EventBus {
     private:
-        std::map<std::type_index, std::unique_ptr<HandlerList>> subscribers;
+        // One contiguous list of handlers per event type, indexed by the TYPE_ID of the event
+        std::array<HandlerList, MAX_EVENT_TYPES> subscribers;
+        int nextSubscriptionId = 1;
+
+        // The event types in queued mode have a queue, the rest are dispatched as they are emitted
+        std::array<std::unique_ptr<IEventQueue>, MAX_EVENT_TYPES> eventQueues;
+        int numEventLanes = 0;
+
+        // The events emitted after a number of ticks, the timer of each one
+        // keeps the type id in its high 32 bits and its index in the low ones
+        TimerWheel timerWheel;
+        std::array<std::unique_ptr<IScheduledEvents>, MAX_EVENT_TYPES> scheduledEvents;
+        typedef void (*EmitScheduledEventFunction)(EventBus& eventBus, int index);
+        std::array<EmitScheduledEventFunction, MAX_EVENT_TYPES> emitScheduledEventFunctions {};
+
+        template <typename TEvent>
+        static void EmitScheduledEvent(EventBus& eventBus, int index) {
+            auto& events = static_cast<ScheduledEvents<TEvent>&>(*eventBus.scheduledEvents[TEvent::TYPE_ID]).events;
+            // A copy, the handlers can schedule more events and grow the list
+            const TEvent event = events[index];
+            eventBus.EmitEvent<TEvent>(event);
+        }
+
+        // While an event is being dispatched the lists are not modified: the
+        // new handlers wait here and the unsubscribed ones are only marked,
+        // everything is applied once no dispatch is walking the lists
+        int dispatchDepth = 0;
+        std::vector<std::pair<int, EventHandler>> pendingSubscribers;
+        bool hasRemovedSubscribers = false;
+
+        // The scoped subscriptions hold a weak reference, they do nothing once the bus is gone
+        std::shared_ptr<EventBus*> self;
+
+        // Events emitted per type since the counts were reset, for the debug overlay
+        std::array<int, MAX_EVENT_TYPES> numEmittedEvents {};
+        std::array<const std::type_info*, MAX_EVENT_TYPES> eventTypes {};
+
+        // Optional, every event is written into it as it is dispatched
+        EventRecorder* recorder = nullptr;
+        typedef void (*RecordEventsFunction)(EventRecorder& recorder, const EventBatch& batch);
+        std::array<RecordEventsFunction, MAX_EVENT_TYPES> recordEventsFunctions {};
+
+        // The events write their fields with a Record(EventRecorder&) method,
+        // the types without one are recorded by their type id alone
+        template <typename TEvent, typename = void>
+        struct HasRecordMethod: std::false_type {};
+
+        template <typename TEvent>
+        struct HasRecordMethod<TEvent, decltype(std::declval<const TEvent&>().Record(std::declval<EventRecorder&>()))>: std::true_type {};
+
+        template <typename TEvent>
+        static void RecordEvents(EventRecorder& recorder, const EventBatch& batch) {
+            const TEvent* events = static_cast<const TEvent*>(batch.events);
+            for (size_t i = 0; i < batch.numEvents; i++) {
+                recorder.BeginEvent(TEvent::TYPE_ID);
+                RecordFields(recorder, events[i], HasRecordMethod<TEvent>());
+                recorder.EndEvent();
+            }
+        }
+
+        template <typename TEvent>
+        static void RecordFields(EventRecorder& recorder, const TEvent& event, std::true_type) {
+            event.Record(recorder);
+        }
+
+        template <typename TEvent>
+        static void RecordFields(EventRecorder&, const TEvent&, std::false_type) {}
+
+        EventSubscription AddHandler(int eventTypeId, EventDelegate delegate, int priority) {
+            EventSubscription subscription;
+            subscription.eventTypeId = eventTypeId;
+            subscription.id = nextSubscriptionId++;
+
+            EventHandler handler { subscription.id, priority, delegate };
+            if (dispatchDepth > 0) {
+                pendingSubscribers.emplace_back(eventTypeId, handler);
+            }
+            else {
+                InsertHandler(subscribers[eventTypeId], handler);
+            }
+            return subscription;
+        }
+
+        // The list is kept sorted by priority when the handler is added, never while dispatching
+        static void InsertHandler(HandlerList& handlers, const EventHandler& handler) {
+            auto position = std::upper_bound(handlers.begin(), handlers.end(), handler, [](const EventHandler& a, const EventHandler& b) {
+                return a.priority > b.priority;
+            });
+            handlers.insert(position, handler);
+        }
+
+        // Every handler receives the whole batch before the next handler runs
+        // A single event that is consumed is not handed to the rest of the handlers
+        void Dispatch(int eventTypeId, EventBatch batch, const Event* singleEvent = nullptr) {
+            dispatchDepth++;
+            for (const auto& handler : subscribers[eventTypeId]) {
+                if (handler.id != 0) {
+                    handler.delegate(batch);
+                    if (singleEvent && singleEvent->IsConsumed()) {
+                        break;
+                    }
+                }
+            }
+            dispatchDepth--;
+            if (dispatchDepth == 0 && (hasRemovedSubscribers || !pendingSubscribers.empty())) {
+                ApplyPendingChanges();
+            }
+        }
+
+        void ApplyPendingChanges() {
+            if (hasRemovedSubscribers) {
+                for (auto& handlers : subscribers) {
+                    handlers.erase(std::remove_if(handlers.begin(), handlers.end(), [](const EventHandler& handler) {
+                        return handler.id == 0;
+                    }), handlers.end());
+                }
+                hasRemovedSubscribers = false;
+            }
+            for (auto& pending : pendingSubscribers) {
+                InsertHandler(subscribers[pending.first], pending.second);
+            }
+            pendingSubscribers.clear();
+        }
+
+        friend class ScopedSubscription;
 
     public:
-        EventBus() {
+        EventBus(): self(std::make_shared<EventBus*>(this)) {
             spdlog::info("EventBus constructor called");
         }
         
@@ -56,40 +273,386 @@ class EventBus {
             spdlog::info("EventBus destructor called");
         }
 
+        EventBus(const EventBus&) = delete;
+        EventBus& operator =(const EventBus&) = delete;
+
+        // The index of the handler list of an event type, known at compile time
+        template <typename TEvent>
+        static constexpr int GetEventTypeId() {
+            static_assert(std::is_base_of<Event, TEvent>::value, "Events must derive from Event");
+            static_assert(TEvent::TYPE_ID >= 0 && TEvent::TYPE_ID < static_cast<int>(MAX_EVENT_TYPES), "The TYPE_ID of the event is out of range");
+            return TEvent::TYPE_ID;
+        }
+
         // Clears the subscribers list
         void Reset() {
-            subscribers.clear();
+            if (dispatchDepth > 0) {
+                for (auto& handlers : subscribers) {
+                    for (auto& handler : handlers) {
+                        handler.id = 0;
+                    }
+                }
+                pendingSubscribers.clear();
+                hasRemovedSubscribers = true;
+                return;
+            }
+            for (auto& handlers : subscribers) {
+                handlers.clear();
+            }
+        }
+
+        int GetNumEmittedEvents(int eventTypeId) const {
+            return numEmittedEvents[eventTypeId];
+        }
+
+        // The name of the event type, null if no event of the type has been emitted yet
+        const char* GetEventTypeName(int eventTypeId) const {
+            return eventTypes[eventTypeId] ? eventTypes[eventTypeId]->name() : nullptr;
+        }
+
+        void ResetEventCounts() {
+            numEmittedEvents.fill(0);
+        }
+
+        /////////////////////////////////////////////////////////////////////// 
+        // Emit an event of type <T> after a number of simulation ticks, and
+        // again every periodTicks ticks if it is not 0, for cooldowns, respawn
+        // delays or periodic ticks. The event is built now and copied on every
+        // firing, so it must be plain data like the queued ones
+        // Example: eventBus->ScheduleEvent<RespawnEvent>(3 * tickRate, 0, entity);
+        /////////////////////////////////////////////////////////////////////// 
+        template <typename TEvent, typename ...TArgs>
+        TimerHandle ScheduleEvent(uint32_t delayTicks, uint32_t periodTicks, TArgs&& ...args) {
+            static_assert(std::is_trivially_copyable<TEvent>::value && std::is_trivially_destructible<TEvent>::value, "Scheduled events must be plain data");
+            constexpr int eventTypeId = GetEventTypeId<TEvent>();
+            if (!scheduledEvents[eventTypeId]) {
+                scheduledEvents[eventTypeId] = std::make_unique<ScheduledEvents<TEvent>>();
+                emitScheduledEventFunctions[eventTypeId] = &EmitScheduledEvent<TEvent>;
+            }
+            auto& events = static_cast<ScheduledEvents<TEvent>&>(*scheduledEvents[eventTypeId]);
+            const int index = events.Add(TEvent(std::forward<TArgs>(args)...));
+            return timerWheel.Schedule(delayTicks, periodTicks, (static_cast<uint64_t>(eventTypeId) << 32) | static_cast<uint32_t>(index));
+        }
+
+        // Returns false if the event had already been emitted for the last time, it is safe to call from a handler
+        bool CancelScheduledEvent(TimerHandle& timer) {
+            if (!timerWheel.IsPending(timer)) {
+                timer = TimerHandle();
+                return false;
+            }
+            const uint64_t userData = timerWheel.GetUserData(timer);
+            scheduledEvents[userData >> 32]->Release(static_cast<int>(userData & 0xFFFFFFFF));
+            return timerWheel.Cancel(timer);
+        }
+
+        bool IsScheduled(const TimerHandle& timer) const {
+            return timerWheel.IsPending(timer);
+        }
+
+        // Once per simulation step, emits the scheduled events that are due
+        // Only the timers that expire in the step are touched, not all of them
+        void AdvanceTimers() {
+            PROFILE_SCOPE("EventBus::AdvanceTimers");
+            timerWheel.Advance([this](const TimerHandle& timer, uint64_t userData, bool isRepeating) {
+                const int eventTypeId = static_cast<int>(userData >> 32);
+                const int index = static_cast<int>(userData & 0xFFFFFFFF);
+                emitScheduledEventFunctions[eventTypeId](*this, index);
+                // Unless a handler cancelled it, which releases the event already
+                if (!isRepeating && timerWheel.IsPending(timer)) {
+                    scheduledEvents[eventTypeId]->Release(index);
+                }
+            });
+        }
+
+        int GetNumScheduledEvents() const {
+            return timerWheel.GetNumPendingTimers();
+        }
+
+        // Simulation steps advanced so far
+        uint64_t GetCurrentTick() const {
+            return timerWheel.GetCurrentTick();
         }
 
         /////////////////////////////////////////////////////////////////////// 
         // Subscribe to an event type <T>
         // In our implementation, a listener subscribes to an event
+        // The subscription lasts until it is unsubscribed, keep the returned
+        // handle or wrap it in a ScopedSubscription owned by the listener
+        // The handlers of higher priority run first, and the events they
+        // consume do not reach the handlers that come after them
         // Example: eventBus->SubscribeToEvent<CollisionEvent>(this, &Game::onCollision);
         /////////////////////////////////////////////////////////////////////// 
         template <typename TEvent, typename TOwner>
-        void SubscribeToEvent(TOwner* ownerInstance, void (TOwner::*callbackFunction)(TEvent&)) {
-            if (!subscribers[typeid(TEvent)].get()) {
-                subscribers[typeid(TEvent)] = std::make_unique<HandlerList>();
+        EventSubscription SubscribeToEvent(TOwner* ownerInstance, void (TOwner::*callbackFunction)(TEvent&), int priority = DEFAULT_EVENT_PRIORITY) {
+            return AddHandler(GetEventTypeId<TEvent>(), EventDelegate::Bind([ownerInstance, callbackFunction](EventBatch batch) {
+                TEvent* events = static_cast<TEvent*>(batch.events);
+                for (size_t i = 0; i < batch.numEvents; i++) {
+                    if (!events[i].IsConsumed()) {
+                        (ownerInstance->*callbackFunction)(events[i]);
+                    }
+                }
+            }), priority);
+        }
+
+        /////////////////////////////////////////////////////////////////////// 
+        // Subscribe any callable that takes the event, a lambda or a free function
+        // It is stored inside the handler list, so its captures can take up to
+        // Delegate::STORAGE_SIZE bytes and are never allocated on the heap
+        // Example: eventBus->SubscribeToEvent<CollisionEvent>([entity](CollisionEvent& event) { ... });
+        /////////////////////////////////////////////////////////////////////// 
+        template <typename TEvent, typename TCallable>
+        EventSubscription SubscribeToEvent(TCallable callable, int priority = DEFAULT_EVENT_PRIORITY) {
+            return AddHandler(GetEventTypeId<TEvent>(), EventDelegate::Bind([callable](EventBatch batch) mutable {
+                TEvent* events = static_cast<TEvent*>(batch.events);
+                for (size_t i = 0; i < batch.numEvents; i++) {
+                    if (!events[i].IsConsumed()) {
+                        callable(events[i]);
+                    }
+                }
+            }), priority);
+        }
+
+        /////////////////////////////////////////////////////////////////////// 
+        // Subscribe to an event type <T> with a handler that takes them all at once
+        // In queued mode it receives every event of the batch, otherwise one by one
+        // The batch includes the events already consumed, check IsConsumed
+        // Example: eventBus->SubscribeToEventBatch<CollisionEvent>(this, &DamageSystem::OnCollisions);
+        /////////////////////////////////////////////////////////////////////// 
+        template <typename TEvent, typename TOwner>
+        EventSubscription SubscribeToEventBatch(TOwner* ownerInstance, void (TOwner::*callbackFunction)(EventSpan<TEvent>), int priority = DEFAULT_EVENT_PRIORITY) {
+            return AddHandler(GetEventTypeId<TEvent>(), EventDelegate::Bind([ownerInstance, callbackFunction](EventBatch batch) {
+                (ownerInstance->*callbackFunction)(EventSpan<TEvent>(static_cast<TEvent*>(batch.events), batch.numEvents));
+            }), priority);
+        }
+
+        // Any callable that takes an EventSpan<T>
+        // Example: eventBus->SubscribeToEventBatch<CollisionEvent>([](EventSpan<CollisionEvent> events) { ... });
+        template <typename TEvent, typename TCallable>
+        EventSubscription SubscribeToEventBatch(TCallable callable, int priority = DEFAULT_EVENT_PRIORITY) {
+            return AddHandler(GetEventTypeId<TEvent>(), EventDelegate::Bind([callable](EventBatch batch) mutable {
+                callable(EventSpan<TEvent>(static_cast<TEvent*>(batch.events), batch.numEvents));
+            }), priority);
+        }
+
+        // Removes the handler of the subscription, it is safe to call from inside a handler
+        void Unsubscribe(EventSubscription& subscription) {
+            if (!subscription.IsValid()) {
+                return;
+            }
+            auto& handlers = subscribers[subscription.eventTypeId];
+            for (auto it = handlers.begin(); it != handlers.end(); it++) {
+                if (it->id != subscription.id) {
+                    continue;
+                }
+                if (dispatchDepth > 0) {
+                    it->id = 0;
+                    hasRemovedSubscribers = true;
+                }
+                else {
+                    handlers.erase(it);
+                }
+                break;
+            }
+            for (auto it = pendingSubscribers.begin(); it != pendingSubscribers.end(); it++) {
+                if (it->second.id == subscription.id) {
+                    pendingSubscribers.erase(it);
+                    break;
+                }
+            }
+            subscription = EventSubscription();
+        }
+
+        /////////////////////////////////////////////////////////////////////// 
+        // Queued mode of an event type <T>
+        // Its events are stored when they are emitted and dispatched later, all
+        // together, by DispatchQueuedEvents. The events are copied as plain data
+        // Example: eventBus->SetQueued<CollisionEvent>(true);
+        /////////////////////////////////////////////////////////////////////// 
+        template <typename TEvent>
+        void SetQueued(bool isQueued) {
+            static_assert(std::is_trivially_copyable<TEvent>::value && std::is_trivially_destructible<TEvent>::value, "Queued events must be plain data");
+            constexpr int eventTypeId = GetEventTypeId<TEvent>();
+            if (isQueued && !eventQueues[eventTypeId]) {
+                eventQueues[eventTypeId] = std::make_unique<EventQueue<TEvent>>();
+                eventQueues[eventTypeId]->SetNumLanes(numEventLanes);
+                eventTypes[eventTypeId] = &typeid(TEvent);
+                recordEventsFunctions[eventTypeId] = &RecordEvents<TEvent>;
+            }
+            else if (!isQueued && eventQueues[eventTypeId] && !eventQueues[eventTypeId]->isDispatching) {
+                // The events already queued are not lost, nor the ones their handlers queue
+                while (eventQueues[eventTypeId]->GetSize() > 0) {
+                    DispatchQueuedEvents(eventTypeId);
+                }
+                eventQueues[eventTypeId].reset();
+            }
+        }
+
+        template <typename TEvent>
+        bool IsQueued() const {
+            return eventQueues[GetEventTypeId<TEvent>()] != nullptr;
+        }
+
+        size_t GetNumQueuedEvents(int eventTypeId) const {
+            return eventQueues[eventTypeId] ? eventQueues[eventTypeId]->GetSize() : 0;
+        }
+
+        // Hands the queued events of a type to its handlers as one batch
+        // Events queued by the handlers meanwhile wait for the next call
+        void DispatchQueuedEvents(int eventTypeId) {
+            auto& eventQueue = eventQueues[eventTypeId];
+            if (!eventQueue || eventQueue->isDispatching || eventQueue->GetSize() == 0) {
+                return;
+            }
+            PROFILE_SCOPE("EventBus::DispatchQueuedEvents");
+            IEventQueue* dispatchingQueue = eventQueue.get();
+            dispatchingQueue->isDispatching = true;
+            const EventBatch batch = dispatchingQueue->TakeBatch();
+            // The events of the lanes can not be counted while they are emitted
+            numEmittedEvents[eventTypeId] += static_cast<int>(batch.numEvents);
+            if (recorder) {
+                recordEventsFunctions[eventTypeId](*recorder, batch);
+            }
+            Dispatch(eventTypeId, batch);
+            dispatchingQueue->isDispatching = false;
+        }
+
+        // Every queued event type, in the order of their TYPE_ID
+        void DispatchQueuedEvents() {
+            for (int eventTypeId = 0; eventTypeId < static_cast<int>(MAX_EVENT_TYPES); eventTypeId++) {
+                DispatchQueuedEvents(eventTypeId);
             }
-            auto subscriber = std::make_unique<EventCallback<TOwner, TEvent>>(ownerInstance, callbackFunction);
-            subscribers[typeid(TEvent)]->push_back(std::move(subscriber));
+        }
+
+        /////////////////////////////////////////////////////////////////////// 
+        // Lanes of the queued event types, to emit from several threads at once
+        // Every lane has its own buffer per type so emitting takes no lock and
+        // no atomic. The lanes are dispatched in order after the events emitted
+        // with EmitEvent, so the order does not depend on the threads when each
+        // lane is filled by one piece of work, e.g. one block of a ParallelFor.
+        // Call it from the thread that dispatches, while nothing is emitting
+        /////////////////////////////////////////////////////////////////////// 
+        void ReserveEventLanes(int numLanes) {
+            if (numLanes <= numEventLanes) {
+                return;
+            }
+            numEventLanes = numLanes;
+            for (auto& eventQueue : eventQueues) {
+                if (eventQueue) {
+                    eventQueue->SetNumLanes(numEventLanes);
+                }
+            }
+        }
+
+        int GetNumEventLanes() const {
+            return numEventLanes;
+        }
+
+        /////////////////////////////////////////////////////////////////////// 
+        // Emit an event of type <T> into a lane of its queue
+        // The type must be in queued mode and the lane reserved, and only one
+        // thread at a time can emit into the same lane
+        // Example: eventBus->EmitEventToLane<CollisionEvent>(block, a, b);
+        /////////////////////////////////////////////////////////////////////// 
+        template <typename TEvent, typename ...TArgs>
+        void EmitEventToLane(int lane, TArgs&& ...args) {
+            constexpr int eventTypeId = GetEventTypeId<TEvent>();
+            auto* eventQueue = static_cast<EventQueue<TEvent>*>(eventQueues[eventTypeId].get());
+            if (!eventQueue || lane < 0 || lane >= static_cast<int>(eventQueue->lanes.size())) {
+                spdlog::error("Event lane {} is not available, the event type is not queued or the lane is not reserved", lane);
+                return;
+            }
+            eventQueue->lanes[lane].events.emplace_back(std::forward<TArgs>(args)...);
         }
 
         /////////////////////////////////////////////////////////////////////// 
         // Emit an event of type <T>
         // In our implementation, as soon as something emits an
-        // event we go ahead and execute all the listener callback functions
+        // event we go ahead and execute all the listener callback functions,
+        // unless the type is in queued mode
+        // The event is built once and every handler receives the same one
         // Example: eventBus->EmitEvent<CollisionEvent>(player, enemy);
         /////////////////////////////////////////////////////////////////////// 
         template <typename TEvent, typename ...TArgs>
         void EmitEvent(TArgs&& ...args) {
-            auto handlers = subscribers[typeid(TEvent)].get();
-            if (handlers) {
-                for (auto it = handlers->begin(); it != handlers->end(); it++) {
-                    auto handler = it->get();
-                    TEvent event(std::forward<TArgs>(args)...);
-                    handler->Execute(event);
-                }
+            PROFILE_SCOPE("EventBus::EmitEvent");
+            constexpr int eventTypeId = GetEventTypeId<TEvent>();
+            if (eventQueues[eventTypeId]) {
+                static_cast<EventQueue<TEvent>&>(*eventQueues[eventTypeId]).events.emplace_back(std::forward<TArgs>(args)...);
+                return;
+            }
+
+            numEmittedEvents[eventTypeId]++;
+            eventTypes[eventTypeId] = &typeid(TEvent);
+            if (subscribers[eventTypeId].empty() && !recorder) {
+                return;
+            }
+            TEvent event(std::forward<TArgs>(args)...);
+            if (recorder) {
+                RecordEvents<TEvent>(*recorder, { &event, 1 });
+            }
+            if (!subscribers[eventTypeId].empty()) {
+                Dispatch(eventTypeId, { &event, 1 }, &event);
+            }
+        }
+
+        /////////////////////////////////////////////////////////////////////// 
+        // Record every event emitted from now on, nullptr stops recording
+        // The queued events are recorded when they are dispatched, so the
+        // recording does not depend on the threads that emitted them
+        /////////////////////////////////////////////////////////////////////// 
+        void SetRecorder(EventRecorder* recorder) {
+            this->recorder = recorder;
+        }
+};
+
+/////////////////////////////////////////////////////////////////////////////////
+// ScopedSubscription
+/////////////////////////////////////////////////////////////////////////////////
+// Unsubscribes when it is destroyed, a listener keeps one per subscription
+// so its handlers never outlive it. It is safe to destroy it after the bus.
+/////////////////////////////////////////////////////////////////////////////////
+class ScopedSubscription {
+    private:
+        std::weak_ptr<EventBus*> eventBus;
+        EventSubscription subscription;
+
+    public:
+        ScopedSubscription() = default;
+
+        ScopedSubscription(EventBus& eventBus, EventSubscription subscription)
+            : eventBus(eventBus.self), subscription(subscription) {}
+
+        ~ScopedSubscription() {
+            Unsubscribe();
+        }
+
+        ScopedSubscription(ScopedSubscription&& other) noexcept
+            : eventBus(std::move(other.eventBus)), subscription(other.subscription) {
+            other.subscription = EventSubscription();
+        }
+
+        ScopedSubscription& operator =(ScopedSubscription&& other) noexcept {
+            if (this != &other) {
+                Unsubscribe();
+                eventBus = std::move(other.eventBus);
+                subscription = other.subscription;
+                other.subscription = EventSubscription();
             }
+            return *this;
         }
-};
\ No newline at end of file
+
+        ScopedSubscription(const ScopedSubscription&) = delete;
+        ScopedSubscription& operator =(const ScopedSubscription&) = delete;
+
+        void Unsubscribe() {
+            if (auto bus = eventBus.lock()) {
+                (*bus)->Unsubscribe(subscription);
+            }
+            eventBus.reset();
+            subscription = EventSubscription();
+        }
+
+        bool IsSubscribed() const {
+            return subscription.IsValid() && !eventBus.expired();
+        }
+};
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "Event.h"
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/////////////////////////////////////////////////////////////////////////////////
+// Delegate
+/////////////////////////////////////////////////////////////////////////////////
+// A handler stored by value: the bound callable lives in a small buffer
+// inside the delegate and is called through a plain function pointer, so
+// the handlers of an event type sit next to each other in a vector and a
+// call is neither virtual nor a pointer chase to a heap allocation.
+// Any callable up to STORAGE_SIZE bytes fits: lambdas, free functions and
+// function objects. The ones that are trivially copyable, most lambdas, are
+// copied as plain bytes; the rest are copied, moved and destroyed through a
+// second function pointer, e.g. a lambda that captures a std::string.
+/////////////////////////////////////////////////////////////////////////////////
+template <typename TArgument>
+class Delegate {
+    public:
+        static constexpr size_t STORAGE_SIZE = 32;
+
+    private:
+        enum Operation {
+            OPERATION_COPY,
+            OPERATION_MOVE,
+            OPERATION_DESTROY
+        };
+
+        typedef void (*InvokeFunction)(void* storage, TArgument argument);
+        typedef void (*ManageFunction)(Operation operation, void* storage, void* otherStorage);
+
+        // Mutable so the callables can keep state between calls, like a mutable lambda
+        alignas(void*) mutable unsigned char storage[STORAGE_SIZE];
+        InvokeFunction invoke = nullptr;
+        // Null when the callable is copied as plain bytes
+        ManageFunction manage = nullptr;
+
+        void CopyFrom(const Delegate& other) {
+            invoke = other.invoke;
+            manage = other.manage;
+            if (manage) {
+                manage(OPERATION_COPY, storage, other.storage);
+            }
+            else {
+                std::memcpy(storage, other.storage, STORAGE_SIZE);
+            }
+        }
+
+        void MoveFrom(Delegate& other) {
+            invoke = other.invoke;
+            manage = other.manage;
+            if (manage) {
+                manage(OPERATION_MOVE, storage, other.storage);
+            }
+            else {
+                std::memcpy(storage, other.storage, STORAGE_SIZE);
+            }
+        }
+
+    public:
+        Delegate() = default;
+
+        Delegate(const Delegate& other) {
+            CopyFrom(other);
+        }
+
+        Delegate(Delegate&& other) noexcept {
+            MoveFrom(other);
+        }
+
+        Delegate& operator =(const Delegate& other) {
+            if (this != &other) {
+                Reset();
+                CopyFrom(other);
+            }
+            return *this;
+        }
+
+        Delegate& operator =(Delegate&& other) noexcept {
+            if (this != &other) {
+                Reset();
+                MoveFrom(other);
+            }
+            return *this;
+        }
+
+        ~Delegate() {
+            Reset();
+        }
+
+        // The callable is copied into the delegate, it never allocates
+        template <typename TCallable>
+        static Delegate Bind(TCallable callable) {
+            static_assert(sizeof(TCallable) <= STORAGE_SIZE, "The callable does not fit in the delegate");
+            static_assert(alignof(TCallable) <= alignof(void*), "The callable is over aligned for the delegate");
+            static_assert(std::is_copy_constructible<TCallable>::value, "The delegates are copied, the callable must be copyable");
+            static_assert(std::is_nothrow_move_constructible<TCallable>::value, "The handler lists move the delegates, the callable can not throw when moved");
+
+            Delegate delegate;
+            new (delegate.storage) TCallable(std::move(callable));
+            delegate.invoke = [](void* storage, TArgument argument) {
+                (*static_cast<TCallable*>(storage))(argument);
+            };
+            if (!std::is_trivially_copyable<TCallable>::value || !std::is_trivially_destructible<TCallable>::value) {
+                delegate.manage = [](Operation operation, void* storage, void* otherStorage) {
+                    TCallable* callable = static_cast<TCallable*>(storage);
+                    TCallable* otherCallable = static_cast<TCallable*>(otherStorage);
+                    switch (operation) {
+                        case OPERATION_COPY:
+                            new (storage) TCallable(*otherCallable);
+                            break;
+                        case OPERATION_MOVE:
+                            new (storage) TCallable(std::move(*otherCallable));
+                            break;
+                        case OPERATION_DESTROY:
+                            callable->~TCallable();
+                            break;
+                    }
+                };
+            }
+            return delegate;
+        }
+
+        void Reset() {
+            if (manage) {
+                manage(OPERATION_DESTROY, storage, nullptr);
+            }
+            invoke = nullptr;
+            manage = nullptr;
+        }
+
+        void operator ()(TArgument argument) const {
+            invoke(storage, argument);
+        }
+
+        explicit operator bool() const {
+            return invoke != nullptr;
+        }
+};
+
+// Contiguous events of one type, only the handler knows the type
+struct EventBatch {
+    void* events;
+    size_t numEvents;
+};
+
+// Every handler receives a batch, an event dispatched right away is a batch of one
+typedef Delegate<EventBatch> EventDelegate;
@@ -0,0 +1,261 @@
+#include "EventRecorder.h"
+#include <spdlog/spdlog.h>
+#include <cstring>
+#include <iterator>
+
+constexpr char EventRecorder::MAGIC[4];
+constexpr uint32_t EventRecorder::VERSION;
+
+static void AppendUint32(std::vector<char>& buffer, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        buffer.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+    }
+}
+
+static uint32_t ReadUint32(const char* bytes) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        value |= static_cast<uint32_t>(static_cast<uint8_t>(bytes[i])) << (i * 8);
+    }
+    return value;
+}
+
+EventRecorder::~EventRecorder() {
+    Stop();
+}
+
+bool EventRecorder::StartRecording(const std::string& filePath, int tickRate) {
+    Stop();
+    file.open(filePath, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        spdlog::error("Error creating the event recording {0}", filePath);
+        return false;
+    }
+
+    std::vector<char> header(MAGIC, MAGIC + sizeof(MAGIC));
+    AppendUint32(header, VERSION);
+    AppendUint32(header, static_cast<uint32_t>(tickRate));
+    file.write(header.data(), header.size());
+
+    this->filePath = filePath;
+    this->tickRate = tickRate;
+    mode = MODE_RECORDING;
+    numTicks = 0;
+    tickInput.clear();
+    tickEvents.clear();
+    spdlog::info("Recording the session into {0}", filePath);
+    return true;
+}
+
+bool EventRecorder::StartReplay(const std::string& filePath) {
+    Stop();
+    std::ifstream input(filePath, std::ios::binary);
+    if (!input) {
+        spdlog::error("Error opening the event recording {0}", filePath);
+        return false;
+    }
+    const std::vector<char> data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+    const size_t headerSize = sizeof(MAGIC) + 8;
+    if (data.size() < headerSize || std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0 || ReadUint32(&data[4]) != VERSION) {
+        spdlog::error("{0} is not an event recording of this version", filePath);
+        return false;
+    }
+
+    replayTicks.clear();
+    replayEvents.clear();
+    ReplayTick* currentTick = nullptr;
+    bool isComplete = false;
+    size_t position = headerSize;
+    while (position < data.size() && !isComplete) {
+        const uint8_t kind = static_cast<uint8_t>(data[position++]);
+        if (kind == RECORD_TICK || kind == RECORD_KEY || kind == RECORD_END) {
+            if (position + 4 > data.size()) {
+                break;
+            }
+            const uint32_t value = ReadUint32(&data[position]);
+            position += 4;
+            if (kind == RECORD_TICK) {
+                if (value >= replayTicks.size()) {
+                    replayTicks.resize(value + 1);
+                }
+                currentTick = &replayTicks[value];
+                currentTick->eventsOffset = replayEvents.size();
+            }
+            else if (kind == RECORD_KEY && currentTick) {
+                currentTick->keys.push_back(static_cast<int32_t>(value));
+            }
+            else if (kind == RECORD_END) {
+                replayTicks.resize(value);
+                isComplete = true;
+            }
+        }
+        else if (kind == RECORD_EVENT) {
+            if (position + 3 > data.size()) {
+                break;
+            }
+            const size_t size = static_cast<uint8_t>(data[position + 1]) | (static_cast<uint8_t>(data[position + 2]) << 8);
+            const size_t recordStart = position - 1;
+            position += 3 + size;
+            if (position > data.size() || !currentTick) {
+                break;
+            }
+            // Kept with its framing, the replayed events are framed the same way
+            replayEvents.insert(replayEvents.end(), data.begin() + recordStart, data.begin() + position);
+            currentTick->eventsSize += position - recordStart;
+        }
+        else {
+            break;
+        }
+    }
+    if (!isComplete) {
+        spdlog::error("The event recording {0} is truncated", filePath);
+        return false;
+    }
+
+    this->filePath = filePath;
+    tickRate = static_cast<int>(ReadUint32(&data[8]));
+    mode = MODE_REPLAYING;
+    numDivergentTicks = 0;
+    firstDivergentTick = -1;
+    tickInput.clear();
+    tickEvents.clear();
+    spdlog::info("Replaying {0}, {1} ticks at {2} ticks/s", filePath, replayTicks.size(), tickRate);
+    return true;
+}
+
+void EventRecorder::Stop() {
+    if (mode == MODE_RECORDING) {
+        std::vector<char> end;
+        end.push_back(static_cast<char>(RECORD_END));
+        AppendUint32(end, numTicks);
+        file.write(end.data(), end.size());
+        file.close();
+        spdlog::info("{0} ticks recorded into {1}", numTicks, filePath);
+    }
+    else if (mode == MODE_REPLAYING) {
+        if (numDivergentTicks > 0) {
+            spdlog::warn("The replay of {0} diverged in {1} ticks, the first one is tick {2}", filePath, numDivergentTicks, firstDivergentTick);
+        }
+        else {
+            spdlog::info("The replay of {0} emitted the recorded events", filePath);
+        }
+    }
+    mode = MODE_NONE;
+}
+
+bool EventRecorder::IsRecording() const {
+    return mode == MODE_RECORDING;
+}
+
+bool EventRecorder::IsReplaying() const {
+    return mode == MODE_REPLAYING;
+}
+
+void EventRecorder::BeginTick(uint32_t tick) {
+    this->tick = tick;
+}
+
+void EventRecorder::EndTick() {
+    if (mode == MODE_RECORDING) {
+        WriteTick();
+    }
+    else if (mode == MODE_REPLAYING) {
+        CompareTick();
+    }
+    tickInput.clear();
+    tickEvents.clear();
+}
+
+void EventRecorder::WriteTick() {
+    numTicks = tick + 1;
+    // The quiet ticks take no space, RECORD_END keeps the count
+    if (tickInput.empty() && tickEvents.empty()) {
+        return;
+    }
+    std::vector<char> header;
+    header.push_back(static_cast<char>(RECORD_TICK));
+    AppendUint32(header, tick);
+    file.write(header.data(), header.size());
+    file.write(tickInput.data(), tickInput.size());
+    file.write(tickEvents.data(), tickEvents.size());
+}
+
+void EventRecorder::CompareTick() {
+    size_t eventsOffset = 0;
+    size_t eventsSize = 0;
+    if (tick < replayTicks.size()) {
+        eventsOffset = replayTicks[tick].eventsOffset;
+        eventsSize = replayTicks[tick].eventsSize;
+    }
+    const bool isSame = eventsSize == tickEvents.size() &&
+        (eventsSize == 0 || std::memcmp(&replayEvents[eventsOffset], tickEvents.data(), eventsSize) == 0);
+    if (!isSame) {
+        if (numDivergentTicks == 0) {
+            firstDivergentTick = static_cast<int>(tick);
+        }
+        numDivergentTicks++;
+    }
+}
+
+void EventRecorder::RecordKey(int32_t symbol) {
+    if (mode != MODE_RECORDING) {
+        return;
+    }
+    tickInput.push_back(static_cast<char>(RECORD_KEY));
+    AppendUint32(tickInput, static_cast<uint32_t>(symbol));
+}
+
+void EventRecorder::BeginEvent(int eventTypeId) {
+    eventStart = tickEvents.size();
+    tickEvents.push_back(static_cast<char>(RECORD_EVENT));
+    tickEvents.push_back(static_cast<char>(eventTypeId));
+    // The size is filled in by EndEvent
+    tickEvents.push_back(0);
+    tickEvents.push_back(0);
+}
+
+void EventRecorder::EndEvent() {
+    const size_t size = tickEvents.size() - eventStart - 4;
+    tickEvents[eventStart + 2] = static_cast<char>(size & 0xFF);
+    tickEvents[eventStart + 3] = static_cast<char>((size >> 8) & 0xFF);
+}
+
+void EventRecorder::WriteUint8(uint8_t value) {
+    tickEvents.push_back(static_cast<char>(value));
+}
+
+void EventRecorder::WriteInt32(int32_t value) {
+    AppendUint32(tickEvents, static_cast<uint32_t>(value));
+}
+
+void EventRecorder::WriteUint32(uint32_t value) {
+    AppendUint32(tickEvents, value);
+}
+
+void EventRecorder::WriteFloat(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    AppendUint32(tickEvents, bits);
+}
+
+int EventRecorder::GetTickRate() const {
+    return tickRate;
+}
+
+uint32_t EventRecorder::GetNumTicks() const {
+    return mode == MODE_REPLAYING ? static_cast<uint32_t>(replayTicks.size()) : numTicks;
+}
+
+const std::vector<int32_t>& EventRecorder::GetReplayKeys(uint32_t tick) const {
+    static const std::vector<int32_t> noKeys;
+    return tick < replayTicks.size() ? replayTicks[tick].keys : noKeys;
+}
+
+int EventRecorder::GetNumDivergentTicks() const {
+    return numDivergentTicks;
+}
+
+int EventRecorder::GetFirstDivergentTick() const {
+    return firstDivergentTick;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/////////////////////////////////////////////////////////////////////////////////
+// EventRecorder
+/////////////////////////////////////////////////////////////////////////////////
+// Records the input and the events of a session tick by tick (.trec), so the
+// session can be replayed headless with the same workload:
+//  - Header: the "TREC" magic, a version and the tick rate, little-endian uint32.
+//  - Records: a uint8 kind followed by its data, all little-endian
+//      RECORD_TICK   uint32 tick, the records that follow belong to that step
+//      RECORD_KEY    int32 symbol of a key pressed before the step
+//      RECORD_EVENT  uint8 event type id, uint16 size and the fields of the event
+//      RECORD_END    uint32 number of ticks
+// The events write their own fields with their Record method, entities by id,
+// so the same session gives the same bytes in every run and every build.
+// When replaying, the events of every tick are compared with the recorded
+// ones instead of written, a replay that diverges is reported when it stops.
+/////////////////////////////////////////////////////////////////////////////////
+class EventRecorder {
+    public:
+        enum RecordKind : uint8_t {
+            RECORD_TICK = 1,
+            RECORD_KEY = 2,
+            RECORD_EVENT = 3,
+            RECORD_END = 4
+        };
+
+        static constexpr char MAGIC[4] = { 'T', 'R', 'E', 'C' };
+        static constexpr uint32_t VERSION = 1;
+
+    private:
+        enum Mode {
+            MODE_NONE,
+            MODE_RECORDING,
+            MODE_REPLAYING
+        };
+
+        // The recorded input and events of one tick, the events point into replayEvents
+        struct ReplayTick {
+            std::vector<int32_t> keys;
+            size_t eventsOffset = 0;
+            size_t eventsSize = 0;
+        };
+
+        Mode mode = MODE_NONE;
+        std::string filePath;
+        std::ofstream file;
+        int tickRate = 0;
+
+        // The records of the tick in progress
+        uint32_t tick = 0;
+        uint32_t numTicks = 0;
+        std::vector<char> tickInput;
+        std::vector<char> tickEvents;
+        size_t eventStart = 0;
+
+        std::vector<ReplayTick> replayTicks;
+        std::vector<char> replayEvents;
+        int numDivergentTicks = 0;
+        int firstDivergentTick = -1;
+
+        void WriteTick();
+        void CompareTick();
+
+    public:
+        EventRecorder() = default;
+        ~EventRecorder();
+
+        EventRecorder(const EventRecorder&) = delete;
+        EventRecorder& operator =(const EventRecorder&) = delete;
+
+        // Creates the file, the ticks are written as they end
+        bool StartRecording(const std::string& filePath, int tickRate);
+        // Loads a whole recording to replay it
+        bool StartReplay(const std::string& filePath);
+        // Writes the end of the recording, or reports how the replay went
+        void Stop();
+
+        bool IsRecording() const;
+        bool IsReplaying() const;
+
+        // Every record between these two calls belongs to the tick
+        void BeginTick(uint32_t tick);
+        void EndTick();
+
+        void RecordKey(int32_t symbol);
+
+        // The EventBus frames every event, the event writes its fields in between
+        void BeginEvent(int eventTypeId);
+        void EndEvent();
+        void WriteUint8(uint8_t value);
+        void WriteInt32(int32_t value);
+        void WriteUint32(uint32_t value);
+        void WriteFloat(float value);
+
+        // Of the recording being replayed
+        int GetTickRate() const;
+        uint32_t GetNumTicks() const;
+        const std::vector<int32_t>& GetReplayKeys(uint32_t tick) const;
+        int GetNumDivergentTicks() const;
+        int GetFirstDivergentTick() const;
+};
@@ -2,10 +2,19 @@
 
 #include "../ECS/ECS.h"
 #include "../EventBus/Event.h"
+#include "../EventBus/EventRecorder.h"
+#include "EventTypes.h"
 
 class CollisionEvent: public Event {
     public:
+        static constexpr int TYPE_ID = EVENT_COLLISION;
+
         Entity a;
         Entity b;
         CollisionEvent(Entity a, Entity b): a(a), b(b) {}
+
+        void Record(EventRecorder& recorder) const {
+            recorder.WriteInt32(a.GetId());
+            recorder.WriteInt32(b.GetId());
+        }
 };
@@ -0,0 +1,11 @@
+#pragma once
+
+// Every event class has a TYPE_ID from this list, the EventBus uses it as
+// the index of its handler lists so emitting an event never searches a map.
+// New events are added at the end, there can be up to MAX_EVENT_TYPES.
+enum EventTypeId {
+    EVENT_COLLISION,
+    EVENT_KEY_PRESSED,
+    EVENT_TILE_COLLISION,
+    NUM_EVENT_TYPES
+};
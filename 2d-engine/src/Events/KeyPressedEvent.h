@@ -2,10 +2,18 @@
 
 #include "../ECS/ECS.h"
 #include "../EventBus/Event.h"
+#include "../EventBus/EventRecorder.h"
+#include "EventTypes.h"
 #include <SDL.h>
 
 class KeyPressedEvent: public Event {
     public:
+        static constexpr int TYPE_ID = EVENT_KEY_PRESSED;
+
         SDL_Keycode symbol;
         KeyPressedEvent(SDL_Keycode symbol): symbol(symbol) {}
+
+        void Record(EventRecorder& recorder) const {
+            recorder.WriteInt32(symbol);
+        }
 };
\ No newline at end of file
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "../ECS/ECS.h"
+#include "../EventBus/Event.h"
+#include "../EventBus/EventRecorder.h"
+#include "EventTypes.h"
+
+class TileCollisionEvent: public Event {
+    public:
+        static constexpr int TYPE_ID = EVENT_TILE_COLLISION;
+
+        Entity entity;
+        int tileCol;
+        int tileRow;
+        TileCollisionEvent(Entity entity, int tileCol, int tileRow): entity(entity), tileCol(tileCol), tileRow(tileRow) {}
+
+        void Record(EventRecorder& recorder) const {
+            recorder.WriteInt32(entity.GetId());
+            recorder.WriteInt32(tileCol);
+            recorder.WriteInt32(tileRow);
+        }
+};
@@ -1,4 +1,5 @@
 #include "Game.h"
+#include "Simulation.h"
 #include <spdlog/spdlog.h>
 #include "../ECS/ECS.h"
 #include "../Components/TransformComponent.h"
@@ -6,6 +7,8 @@
 #include "../Components/SpriteComponent.h"
 #include "../Components/AnimationComponent.h"
 #include "../Components/BoxColliderComponent.h"
+#include "../Components/CameraComponent.h"
+#include "../Components/TilemapComponent.h"
 #include "../Systems/MovementSystem.h"
 #include "../Systems/RenderSystem.h"
 #include "../Systems/AnimationSystem.h"
@@ -13,19 +16,32 @@
 #include "../Systems/RenderColliderSystem.h"
 #include "../Systems/DamageSystem.h" 
 #include "../Systems/KeyboardControlSystem.h"
+#include "../Systems/TileCollisionSystem.h"
+#include "../Systems/CameraMovementSystem.h"
+#include "../Systems/TilemapRenderSystem.h"
+#include "../Tilemap/TilemapLoader.h"
+#include "LevelConfig.h"
+#include "../World/WorldStreamer.h"
 #include "../Events/KeyPressedEvent.h"
+#include "../Profiler/Profiler.h"
 #include <SDL.h>
 #include <SDL_image.h>
 #include <glm/glm.hpp>
 #include <iostream>
 #include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <thread>
 
 Game::Game() {
 	isRunning = false;
 	isDebug = false;
+	// The main thread and the simulation thread are busy already
+	threadPool = std::make_unique<ThreadPool>(std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 2));
 	registry = std::make_unique<Registry>();
 	assetStore = std::make_unique<AssetStore>();
 	eventBus = std::make_unique<EventBus>();
+	worldStreamer = std::make_unique<WorldStreamer>();
 	spdlog::info("Game constructor called");
 }
 
@@ -34,11 +50,27 @@ Game::~Game() {
 }
 
 void Game::Initialize() {
+	// Without video there is no window nor renderer, only the simulation runs
+	if (isHeadless) {
+		if (SDL_Init(SDL_INIT_TIMER | SDL_INIT_EVENTS) != 0) {
+			spdlog::error("Error initializing SDL");
+			return;
+		}
+		isRunning = true;
+		return;
+	}
+
 	if (SDL_Init(SDL_INIT_EVERYTHING)!=0) {
 		spdlog::error("Error initializing SDL");
 		return;
 	}
 
+	// The codecs are set up here, on this thread, before the workers decode images at the same time
+	if ((IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG) != IMG_INIT_PNG) {
+		spdlog::error("Error initializing SDL_image: {0}", IMG_GetError());
+		return;
+	}
+
 	if (isFullscreen) {
 		SDL_DisplayMode displayMode;
 		SDL_GetCurrentDisplayMode(0, &displayMode);
@@ -74,16 +106,26 @@ void Game::Initialize() {
 		SDL_SetWindowFullscreen(window, SDL_WINDOW_FULLSCREEN);
 	}
 
+	debugOverlay.Initialize(renderer, windowWidth, windowHeight);
+
 	isRunning = true;
 }
 
 void Game::ProcessInput() {
+	PROFILE_SCOPE("Game::ProcessInput");
 	SDL_Event sdlEvent;
 	while (SDL_PollEvent(&sdlEvent)) {
+		if (!isHeadless) {
+			debugOverlay.ProcessEvent(sdlEvent);
+		}
 		switch (sdlEvent.type) {
 			case SDL_QUIT:
 				isRunning = false;
 				break;
+			case SDL_RENDER_TARGETS_RESET:
+				// The content of the baked tilemap chunks has been lost
+				snapshotRenderer.Invalidate();
+				break;
 			case SDL_KEYDOWN:
 				if (sdlEvent.key.keysym.sym == SDLK_ESCAPE) {
 					isRunning = false;
@@ -91,57 +133,92 @@ void Game::ProcessInput() {
 				if (sdlEvent.key.keysym.sym == SDLK_d) {
 					isDebug = !isDebug;
 				}
-				eventBus->EmitEvent<KeyPressedEvent>(sdlEvent.key.keysym.sym);
+				if (sdlEvent.key.keysym.sym == SDLK_o && !isHeadless) {
+					isOverlayVisible = !isOverlayVisible;
+					Profiler::SetCollectingTimings(isOverlayVisible);
+				}
+				if (sdlEvent.key.keysym.sym == SDLK_p) {
+					ToggleProfilerCapture();
+				}
+				{
+					std::lock_guard<std::mutex> lock(inputMutex);
+					pressedKeys.push_back(sdlEvent.key.keysym.sym);
+				}
 				break;
 		}
 	}
 }
 
-void Game::LoadLevel(int level) {
+bool Game::LoadLevel(int level) {
 	 
 	// Add the sytems that need to be processed in our game
-	registry->AddSystem<MovementSystem>();
+	Simulation::AddSystems(*registry);
 	registry->AddSystem<RenderSystem>();
-	registry->AddSystem<AnimationSystem>();
-	registry->AddSystem<CollisionSystem>();
 	registry->AddSystem<RenderColliderSystem>();
-	registry->AddSystem<DamageSystem>();
-	registry->AddSystem<KeyboardControlSystem>();
-
-	// Adding assets to the asset store
-	assetStore->AddTexture(renderer, "tank-image", "./assets/images/tank-panther-right.png");
-	assetStore->AddTexture(renderer, "truck-image", "./assets/images/truck-ford-right.png");
-	assetStore->AddTexture(renderer, "chopper-image", "./assets/images/chopper.png");
-	assetStore->AddTexture(renderer, "radar-image", "./assets/images/radar.png");
-	assetStore->AddTexture(renderer, "tilemap-image", "./assets/tilemaps/jungle.png");
-
-	// Load the tilemap
-	int tileSize = 32;
-	double tileScale = 1.0;
-	int mapNumCols = 25;
-	int mapNumRows = 20;
+	registry->AddSystem<CameraMovementSystem>();
+	registry->AddSystem<TilemapRenderSystem>();
+
+	// The subscriptions last as long as the systems, they are not renewed every frame
+	Simulation::SubscribeToEvents(*registry, eventBus);
+
+	// Crowded levels split the narrowphase between the workers
+	registry->GetSystem<CollisionSystem>().SetThreadPool(threadPool.get());
+
+	// Adding assets to the asset store, nothing is drawn without a renderer
+	// The images are decoded by the workers, they are drawn as placeholders until Render uploads them
+	if (!isHeadless) {
+		assetStore->LoadTextureAsync(renderer, "tank-image", "./assets/images/tank-panther-right.png", *threadPool);
+		assetStore->LoadTextureAsync(renderer, "truck-image", "./assets/images/truck-ford-right.png", *threadPool);
+		assetStore->LoadTextureAsync(renderer, "chopper-image", "./assets/images/chopper.png", *threadPool);
+		assetStore->LoadTextureAsync(renderer, "radar-image", "./assets/images/radar.png", *threadPool);
+		assetStore->LoadTextureAsync(renderer, LEVEL_TILESET_ASSET_ID, LEVEL_TILESET_PATH, *threadPool);
+	}
 
-	// We need to load the tilemap texture from ./assets/tilemaps/jungle.png
-	// We need to load the file ./assets/tilemaps/jungle.map
-	std::fstream mapFile;
-	mapFile.open("./assets/tilemaps/jungle.map");
+	const int tileSize = LEVEL_TILE_SIZE;
+	const double tileScale = LEVEL_TILE_SCALE;
+	glm::vec2 worldSize;
+
+	// Very large worlds are streamed by chunks around the camera, a world is built from a .map with
+	// 2d-engine --build-world ./assets/tilemaps/jungle.map ./assets/tilemaps/jungle.tworld 8192 8192
+	const std::string worldFilePath = "./assets/tilemaps/jungle.tworld";
+	const std::string tilesetFilePath = isHeadless ? "" : LEVEL_TILESET_PATH;
+	if (std::ifstream(worldFilePath) && worldStreamer->Open(worldFilePath, tilesetFilePath, tileSize, tileScale)) {
+		// One bit per tile of the whole world, only the resident chunks have their solid bits set
+		auto tileCollisionLayer = std::make_shared<TileCollisionLayer>(worldStreamer->GetNumCols(), worldStreamer->GetNumRows(), static_cast<float>(tileScale * tileSize));
+		worldStreamer->SetTileCollisionLayer(tileCollisionLayer, LEVEL_SOLID_TILE_IDS);
+		registry->GetSystem<TileCollisionSystem>().SetTileCollisionLayer(tileCollisionLayer);
+
+		// The units of a chunk live while the chunk is resident
+		worldStreamer->SetSpawnFunction([this](const ChunkSpawn& spawn) {
+			Entity unit = registry->CreateEntity();
+			unit.AddComponent<TransformComponent>(spawn.position, glm::vec2(1.0, 1.0), 0.0);
+			unit.AddComponent<RigidBodyComponent>(spawn.velocity);
+			unit.AddComponent<SpriteComponent>(spawn.type == SPAWN_TRUCK ? "truck-image" : "tank-image", 32, 32, 2);
+			unit.AddComponent<BoxColliderComponent>(32, 32);
+			return unit;
+		});
+		worldSize = glm::vec2(worldStreamer->GetWorldWidth(), worldStreamer->GetWorldHeight());
+	}
+	else {
+		// Load the tilemap, a .map while editing the level or its .tmap binary version
+		auto tilemap = std::make_shared<Tilemap>();
+		if (!TilemapLoader::Load(LEVEL_TILEMAP_PATH, *tilemap, tileSize, tileScale, LEVEL_TILESET_ASSET_ID)) {
+			spdlog::error("Error loading the level {0}", level);
+			return false;
+		}
 
-	for (int y = 0; y < mapNumRows; y++) {
-		for (int x = 0; x < mapNumCols; x++) {
-			char ch;
-			mapFile.get(ch);
-			int srcRectY = std::atoi(&ch) * tileSize;
-			mapFile.get(ch);
-			int srcRectX = std::atoi(&ch) * tileSize;
-			mapFile.ignore();
+		auto tileCollisionLayer = TilemapLoader::BuildCollisionLayer(*tilemap, LEVEL_SOLID_TILE_IDS);
 
-			Entity tile = registry->CreateEntity();
-			tile.AddComponent<TransformComponent>(glm::vec2(x * (tileScale * tileSize), y * (tileScale * tileSize)), glm::vec2(tileScale, tileScale), 0.0);
-			tile.AddComponent<SpriteComponent>("tilemap-image", tileSize, tileSize, 0, srcRectX, srcRectY);
-		}
+		// The whole map is a single entity, its chunks are baked by the TilemapRenderSystem when they become visible
+		Entity map = registry->CreateEntity();
+		map.AddComponent<TilemapComponent>(tilemap, tileCollisionLayer);
+		registry->GetSystem<TileCollisionSystem>().SetTileCollisionLayer(tileCollisionLayer);
+		worldSize = glm::vec2(tilemap->GetNumCols() * tileSize * tileScale, tilemap->GetNumRows() * tileSize * tileScale);
 	}
 
-	mapFile.close();
+	// The camera can not leave the map
+	camera.SetViewportSize(windowWidth, windowHeight);
+	camera.SetWorldSize(worldSize);
 
 	// Create entities
 	Entity chopper = registry->CreateEntity();
@@ -149,11 +226,12 @@ void Game::LoadLevel(int level) {
 	chopper.AddComponent<RigidBodyComponent>(glm::vec2(0.0, 0.0));
 	chopper.AddComponent<SpriteComponent>("chopper-image", 32, 32, 1);
 	chopper.AddComponent<AnimationComponent>(2, 15, true);
+	chopper.AddComponent<CameraComponent>();
 
 	Entity radar = registry->CreateEntity();
 	radar.AddComponent<TransformComponent>(glm::vec2(windowWidth - 74, 10.0), glm::vec2(1.0, 1.0), 0.0);
 	radar.AddComponent<RigidBodyComponent>(glm::vec2(0.0, 0.0));
-	radar.AddComponent<SpriteComponent>("radar-image", 64, 64, 1);
+	radar.AddComponent<SpriteComponent>("radar-image", 64, 64, 1, 0, 0, true);
 	radar.AddComponent<AnimationComponent>(8, 5, true);
 
 	Entity tank = registry->CreateEntity();
@@ -167,65 +245,336 @@ void Game::LoadLevel(int level) {
 	truck.AddComponent<RigidBodyComponent>(glm::vec2(20.0, 0.0));
 	truck.AddComponent<SpriteComponent>("truck-image", 32, 32, 2);
 	truck.AddComponent<BoxColliderComponent>(32, 32);
+	return true;
 }
 
 void Game::Setup(){
-	LoadLevel(1);
+	if (!LoadLevel(1)) {
+		isRunning = false;
+		return;
+	}
+
+	// Recorded or replayed from the first step, the replay runs as many steps as were recorded
+	if (!replayPath.empty()) {
+		if (!eventRecorder.StartReplay(replayPath) || eventRecorder.GetNumTicks() == 0) {
+			isRunning = false;
+			return;
+		}
+		SetTickRate(eventRecorder.GetTickRate());
+		maxTicks = static_cast<int>(eventRecorder.GetNumTicks());
+		stepTimesMs.reserve(maxTicks);
+		eventBus->SetRecorder(&eventRecorder);
+	}
+	else if (!recordPath.empty() && eventRecorder.StartRecording(recordPath, tickRate)) {
+		eventBus->SetRecorder(&eventRecorder);
+	}
+
+	// The streamed chunks spawn entities and solid tiles, a replay only matches if they arrive in the same steps
+	worldStreamer->SetSynchronous(eventRecorder.IsRecording() || eventRecorder.IsReplaying());
 }
 
-void Game::Update(){
-	// If we are too fast, waste time until reach MILLISECS_PER_FRAME
-	Uint32 timeToWait = static_cast<Uint32>(MILLISECS_PER_FRAME) - (SDL_GetTicks() - static_cast<Uint32>(millisecsPreviousFrame));
-	if (timeToWait > 0 && timeToWait <= MILLISECS_PER_FRAME) {
-		SDL_Delay(timeToWait);
+void Game::Update(double deltaTime){
+	PROFILE_SCOPE("Game::Update");
+
+	// The renderer interpolates from where the camera was at the start of the step
+	previousCameraPosition = camera.GetPosition();
+
+	eventRecorder.BeginTick(numTicks);
+
+	// Emit the keys pressed on the main thread since the last frame
+	{
+		std::lock_guard<std::mutex> lock(inputMutex);
+		keysToEmit.swap(pressedKeys);
+	}
+	// A replay emits the keys of the recording instead
+	if (eventRecorder.IsReplaying()) {
+		const auto& recordedKeys = eventRecorder.GetReplayKeys(numTicks);
+		keysToEmit.assign(recordedKeys.begin(), recordedKeys.end());
+	}
+	for (auto symbol : keysToEmit) {
+		eventRecorder.RecordKey(symbol);
+		eventBus->EmitEvent<KeyPressedEvent>(symbol);
 	}
+	keysToEmit.clear();
 
-	// Difference in ticks since last frame in seconds
-	double deltaTime = (SDL_GetTicks() - millisecsPreviousFrame) / 1000.0;
+	Simulation::Update(*registry, eventBus, deltaTime);
+	registry->GetSystem<CameraMovementSystem>().Update(camera);
+
+	// Load the chunks of the world around the new camera position
+	worldStreamer->Update(camera);
+
+	eventRecorder.EndTick();
+}
 
-	// Store current frame time
-	millisecsPreviousFrame = SDL_GetTicks();
+void Game::PublishRenderSnapshot(double stepSeconds, int numSteps) {
+	PROFILE_SCOPE("Game::PublishRenderSnapshot");
+	RenderSnapshot& snapshot = renderSnapshots.GetBack();
+	snapshot.Clear();
+	snapshot.camera = camera;
+	snapshot.previousCameraPosition = previousCameraPosition;
+	snapshot.stepSeconds = stepSeconds;
 
-	// Reset all event handlers for the current frame
-	eventBus->Reset();
+	registry->GetSystem<TilemapRenderSystem>().BuildSnapshot(snapshot);
+	registry->GetSystem<RenderSystem>().BuildSnapshot(*assetStore, camera, snapshot);
+	if (isDebug) {
+		registry->GetSystem<RenderColliderSystem>().BuildSnapshot(snapshot);
+	}
+	if (isOverlayVisible) {
+		CollectDebugStats(snapshot.debugStats, numSteps);
+		snapshot.hasDebugStats = true;
+	}
+	eventBus->ResetEventCounts();
 
-	// Perform the subscription of the events for all systems
-	registry->GetSystem<DamageSystem>().SubscribeToEvents(eventBus);
-	registry->GetSystem<KeyboardControlSystem>().SubscribeToEvents(eventBus);
+	snapshot.publishTime = std::chrono::steady_clock::now();
+	renderSnapshots.Publish();
+}
 
-	//Update the registry to process the entities that are waiting to be created/deleted
-	registry->Update();
+void Game::CollectDebugStats(DebugStats& stats, int numSteps) {
+	Profiler::TakeThreadTimings(stats.timings);
+	stats.nanosecondsPerTick = Profiler::GetNanosecondsPerTick();
+	stats.numSteps = numSteps;
+
+	stats.numEntities = registry->GetNumAliveEntities();
+	registry->ForEachSystem([&](const char* name, const System& system) {
+		stats.systems.push_back({ name, static_cast<int>(system.GetSystemEntities().size()) });
+	});
+	registry->ForEachComponentPool([&](int componentId, const IPool& pool) {
+		stats.pools.push_back({ pool.GetComponentName(), registry->GetNumEntitiesWithComponent(componentId), pool.GetSize(), pool.GetMemoryUsage() });
+	});
+	for (int eventTypeId = 0; eventTypeId < static_cast<int>(MAX_EVENT_TYPES); eventTypeId++) {
+		if (eventBus->GetEventTypeName(eventTypeId)) {
+			stats.events.push_back({ eventBus->GetEventTypeName(eventTypeId), eventBus->GetNumEmittedEvents(eventTypeId) });
+		}
+	}
 
-	// Invoke all the systems that need to update
-	registry->GetSystem<MovementSystem>().Update(deltaTime);
-	registry->GetSystem<AnimationSystem>().Update();
-	registry->GetSystem<CollisionSystem>().Update(eventBus);
+	const auto& collisionSystem = registry->GetSystem<CollisionSystem>();
+	stats.numCandidatePairs = collisionSystem.GetNumCandidatePairs();
+	stats.numCollisions = collisionSystem.GetNumCollisions();
 }
 
-void Game::Render(){
+bool Game::Render(){
+	// A few textures per frame, so a level full of images does not stall a single frame
+	const bool isTextureUploaded = assetStore->UploadLoadedTextures(renderer, MAX_TEXTURE_UPLOADS_PER_FRAME) > 0;
+
+	// Once the last snapshot has been drawn in its final state there is nothing new
+	// to draw until the next one, keep processing the window events meanwhile
+	bool isNewSnapshot = renderSnapshots.Acquire();
+	if (!isNewSnapshot && lastInterpolation >= 1.0f && !isTextureUploaded) {
+		renderSnapshots.WaitForPublish(std::chrono::duration_cast<std::chrono::microseconds>(framePacer.GetTargetFrameTime()));
+		isNewSnapshot = renderSnapshots.Acquire();
+		if (!isNewSnapshot) {
+			return false;
+		}
+	}
+	PROFILE_SCOPE("Game::Render");
+	const RenderSnapshot& snapshot = renderSnapshots.GetFront();
+
+	// Draw the state in between the previous and the current step
+	const float interpolation = snapshot.GetInterpolation(std::chrono::steady_clock::now());
+	Camera interpolatedCamera = snapshot.camera;
+	interpolatedCamera.SetPosition(glm::mix(snapshot.previousCameraPosition, snapshot.camera.GetPosition(), interpolation));
+	lastInterpolation = interpolation;
+
 	SDL_SetRenderDrawColor(renderer, 21, 21, 21, 255);
 	SDL_RenderClear(renderer);
 
-	// Invoke all the systems that need to render 
-	registry->GetSystem<RenderSystem>().Update(renderer, assetStore);
-	if (isDebug) {
-		registry->GetSystem<RenderColliderSystem>().Update(renderer);
+	// The world is the background, it is drawn under every sprite
+	worldStreamer->Render(renderer, interpolatedCamera);
+	snapshotRenderer.Render(renderer, *assetStore, snapshot, interpolatedCamera, interpolation);
+
+	// The stats arrive one snapshot after the overlay is shown
+	if (isOverlayVisible && snapshot.hasDebugStats) {
+		debugOverlay.Render(snapshot.debugStats, isNewSnapshot, framePacer, snapshotRenderer);
 	}
 
 	SDL_RenderPresent(renderer);
+	return true;
 }
 
 void Game::Run() {
 	Setup();
+
+	Profiler::SetThreadName("Main");
+	if (!profilePath.empty()) {
+		Profiler::StartCapture();
+	}
+
+	if (isHeadless) {
+		RunSimulation();
+		return;
+	}
+
+	// The simulation runs in its own thread while this one keeps the window events
+	// and the renderer, so a frame costs max(simulation, render) instead of their sum
+	std::thread simulationThread(&Game::RunSimulation, this);
 	while (isRunning) {
 		ProcessInput();
-		Update();
-		Render();
+		if (Render()) {
+			framePacer.WaitForNextFrame();
+		}
 	}
+	simulationThread.join();
+}
+
+void Game::RunSimulation() {
+	using Clock = std::chrono::steady_clock;
+	const auto startTime = Clock::now();
+	auto previousTime = startTime;
+	double accumulator = 0.0;
+	numTicks = 0;
+
+	if (!isHeadless) {
+		Profiler::SetThreadName("Simulation");
+	}
+
+	while (isRunning) {
+		// Headless there is no main loop, the quit events (Ctrl+C) are processed here
+		if (isHeadless) {
+			ProcessInput();
+		}
+
+		const double stepSeconds = 1.0 / tickRate;
+
+		// As fast as possible, every step simulates the same time no matter how long it took
+		if (isUnpaced) {
+			const auto stepStart = Clock::now();
+			Update(stepSeconds);
+			if (eventRecorder.IsReplaying()) {
+				stepTimesMs.push_back(static_cast<float>(std::chrono::duration<double, std::milli>(Clock::now() - stepStart).count()));
+			}
+			numTicks++;
+			if (maxTicks > 0 && numTicks >= maxTicks) {
+				isRunning = false;
+			}
+			continue;
+		}
+
+		const auto now = Clock::now();
+		accumulator += std::chrono::duration<double>(now - previousTime).count();
+		previousTime = now;
+
+		// Simulate the time passed in fixed steps, whatever the frame rate is
+		int numSteps = 0;
+		while (accumulator >= stepSeconds && numSteps < maxStepsPerFrame && isRunning) {
+			Update(stepSeconds);
+			accumulator -= stepSeconds;
+			numSteps++;
+			numTicks++;
+			if (maxTicks > 0 && numTicks >= maxTicks) {
+				isRunning = false;
+			}
+		}
+
+		// Too far behind to catch up, drop the lag instead of falling further behind every frame
+		if (accumulator >= stepSeconds) {
+			accumulator = std::fmod(accumulator, stepSeconds);
+		}
+
+		if (numSteps > 0) {
+			if (!isHeadless) {
+				PublishRenderSnapshot(stepSeconds, numSteps);
+			}
+		}
+		else {
+			// Wait for the next step
+			FramePacer::SleepUntil(now + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(stepSeconds - accumulator)));
+		}
+	}
+
+	const double seconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+	spdlog::info("{0} ticks simulated in {1:.3f} s, {2:.1f} ticks/s", numTicks, seconds, seconds > 0.0 ? numTicks / seconds : 0.0);
+
+	if (!stepTimesMs.empty()) {
+		double sumMs = 0.0;
+		for (float stepMs : stepTimesMs) {
+			sumMs += stepMs;
+		}
+		std::sort(stepTimesMs.begin(), stepTimesMs.end());
+		const size_t p99Index = std::min(stepTimesMs.size() - 1, stepTimesMs.size() * 99 / 100);
+		spdlog::info("{0} steps replayed, mean {1:.3f} ms, min {2:.3f} ms, max {3:.3f} ms, p99 {4:.3f} ms",
+			stepTimesMs.size(), sumMs / stepTimesMs.size(), stepTimesMs.front(), stepTimesMs.back(), stepTimesMs[p99Index]);
+	}
+}
+
+void Game::SetTickRate(int tickRate) {
+	this->tickRate = std::max(1, tickRate);
+}
+
+void Game::SetMaxStepsPerFrame(int maxStepsPerFrame) {
+	this->maxStepsPerFrame = std::max(1, maxStepsPerFrame);
+}
+
+void Game::SetFrameRate(double framesPerSecond) {
+	framePacer.SetTargetFrameRate(framesPerSecond);
+}
+
+void Game::SetHeadless(bool isHeadless) {
+	this->isHeadless = isHeadless;
+}
+
+void Game::SetUnpaced(bool isUnpaced) {
+	this->isUnpaced = isUnpaced;
+	if (isUnpaced) {
+		isHeadless = true;
+	}
+}
+
+void Game::SetMaxTicks(int maxTicks) {
+	this->maxTicks = maxTicks;
+}
+
+void Game::SetProfilePath(const std::string& profilePath) {
+	this->profilePath = profilePath;
+}
+
+void Game::SetRecordPath(const std::string& recordPath) {
+	this->recordPath = recordPath;
+}
+
+void Game::SetReplayPath(const std::string& replayPath) {
+	this->replayPath = replayPath;
+	isHeadless = true;
+	isUnpaced = true;
+}
+
+void Game::ToggleProfilerCapture() {
+	if (!Profiler::IsCapturing()) {
+		Profiler::StartCapture();
+		return;
+	}
+	// The simulation thread may still be in the middle of a step, its open scopes end up in the next capture
+	Profiler::StopCapture();
+	Profiler::WriteChromeTrace(profilePath.empty() ? DEFAULT_PROFILE_PATH : profilePath);
 }
 
 void Game::Destroy(){
-	SDL_DestroyRenderer(renderer);
-	SDL_DestroyWindow(window);
+	if (Profiler::IsCapturing()) {
+		ToggleProfilerCapture();
+	}
+
+	eventBus->SetRecorder(nullptr);
+	eventRecorder.Stop();
+
+	const FramePacer::FrameStats frameStats = framePacer.GetStats();
+	if (frameStats.numFrames > 0) {
+		spdlog::info("{0} frames, mean {1:.3f} ms, std dev {2:.3f} ms, min {3:.3f} ms, max {4:.3f} ms, p99 {5:.3f} ms, {6} late",
+			frameStats.numFrames, frameStats.meanMs, frameStats.stdDevMs, frameStats.minMs, frameStats.maxMs, frameStats.p99Ms, frameStats.numLateFrames);
+	}
+
+	// Textures must be destroyed while their renderer is still alive
+	debugOverlay.Destroy();
+	snapshotRenderer.Clear();
+	worldStreamer->Close();
+	assetStore->ClearAssets();
+	// The workers may still be decoding images, they finish before SDL quits
+	threadPool.reset();
+
+	if (renderer) {
+		SDL_DestroyRenderer(renderer);
+	}
+	if (window) {
+		SDL_DestroyWindow(window);
+	}
+	IMG_Quit();
 	SDL_Quit();
 }
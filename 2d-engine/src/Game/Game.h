@@ -5,23 +5,83 @@
 #include "../ECS/ECS.h"
 #include "../AssetStore/AssetStore.h"
 #include "../EventBus/EventBus.h" 
+#include "../Camera/Camera.h"
+#include "../World/WorldStreamer.h"
+#include "../Renderer/RenderSnapshot.h"
+#include "../Renderer/SnapshotRenderer.h"
+#include "../Renderer/TripleBuffer.h"
+#include "../Timing/FramePacer.h"
+#include "../Debug/DebugOverlay.h"
+#include "../Threading/ThreadPool.h"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
 
+// Default frame rate of the render loop, paced by the FramePacer
 const int FPS = 60;
-const int MILLISECS_PER_FRAME = 1000 / FPS;
+
+// The simulation runs in fixed steps, independent of the frames drawn
+const int DEFAULT_TICK_RATE = 60;
+// Steps run at most to catch up after a slow frame, the rest of the lag is dropped
+const int MAX_STEPS_PER_FRAME = 5;
+// Decoded images uploaded to the GPU per frame, the rest wait for the next frames
+const int MAX_TEXTURE_UPLOADS_PER_FRAME = 2;
+
+// Where the P key writes the profiler capture when no path is given
+const char* const DEFAULT_PROFILE_PATH = "./profile.json";
 
 class Game {
 private:
-	bool isRunning = false;
-	bool isDebug;
-	double millisecsPreviousFrame = 0;
+	// Shared by the main thread and the simulation thread
+	std::atomic<bool> isRunning { false };
+	std::atomic<bool> isDebug { false };
+	std::atomic<bool> isOverlayVisible { false };
+	// Headless there is no window, no renderer and no render thread
+	bool isHeadless = false;
+	// Run the steps back to back instead of at the tick rate
+	bool isUnpaced = false;
+	// Stop after this number of steps, 0 runs until quit
+	int maxTicks = 0;
+	int numTicks = 0;
+	// Profile the whole run into this Chrome trace, the P key toggles a capture anyway
+	std::string profilePath;
+	// Record the input and the events of the session, or replay a recorded one headless
+	std::string recordPath;
+	std::string replayPath;
+	EventRecorder eventRecorder;
+	// Time of every replayed step, to compare the builds that replay the same session
+	std::vector<float> stepTimesMs;
+
+	int tickRate = DEFAULT_TICK_RATE;
+	int maxStepsPerFrame = MAX_STEPS_PER_FRAME;
+	glm::vec2 previousCameraPosition = glm::vec2(0.0);
+	float lastInterpolation = 1.0f;
+
+	FramePacer framePacer { FPS };
 
 	bool isFullscreen = false;
 	bool isFakeFullscreen = false; // 800x600 escalados
 	int windowMode = SDL_WINDOW_RESIZABLE;
 
+	// Workers of the simulation, declared first so they outlive the systems that use them
+	std::unique_ptr<ThreadPool> threadPool;
 	std::unique_ptr<Registry> registry;  // Registry* registry;
 	std::unique_ptr<AssetStore> assetStore;
 	std::unique_ptr<EventBus> eventBus;
+	std::unique_ptr<WorldStreamer> worldStreamer;
+
+	Camera camera;
+
+	// The simulation publishes a snapshot of every frame, the main thread draws the latest one
+	TripleBuffer<RenderSnapshot> renderSnapshots;
+	SnapshotRenderer snapshotRenderer;
+	DebugOverlay debugOverlay;
+
+	// Keys pressed since the last simulation frame, the events are emitted by the simulation thread
+	std::mutex inputMutex;
+	std::vector<SDL_Keycode> pressedKeys;
+	std::vector<SDL_Keycode> keysToEmit;
 
 	SDL_Window *window = NULL;
 	SDL_Renderer *renderer = NULL;
@@ -31,13 +91,36 @@ public:
 
 	void Initialize();
 	void Run();
-	void LoadLevel(int level);
+	// Returns false if the level could not be loaded
+	bool LoadLevel(int level);
 	void Setup();
 	void ProcessInput();
-	void Update();
-	void Render();
+	void RunSimulation();
+	void Update(double deltaTime);
+	void PublishRenderSnapshot(double stepSeconds, int numSteps);
+	void CollectDebugStats(DebugStats& stats, int numSteps);
+	// Returns false if there was nothing new to draw
+	bool Render();
 	void Destroy();
 
+	// Simulation steps per second, e.g. 30 to run the physics at 30 Hz while drawing at 144 Hz
+	void SetTickRate(int tickRate);
+	void SetMaxStepsPerFrame(int maxStepsPerFrame);
+	void SetFrameRate(double framesPerSecond);
+
+	// Must be set before Initialize
+	void SetHeadless(bool isHeadless);
+	// Unpaced is headless too, its steps never publish a render snapshot for a window
+	void SetUnpaced(bool isUnpaced);
+	void SetMaxTicks(int maxTicks);
+	void SetProfilePath(const std::string& profilePath);
+	void SetRecordPath(const std::string& recordPath);
+	// Replaying is headless and unpaced, at the tick rate of the recording
+	void SetReplayPath(const std::string& replayPath);
+
+	// Starts a profiler capture, or stops it and writes the trace
+	void ToggleProfilerCapture();
+
 	int windowWidth = 800;
 	int windowHeight = 600;
 };
@@ -0,0 +1,16 @@
+#pragma once
+#include <set>
+
+// The jungle level, shared by the game and the command line tools so they load the same map
+
+// Size in pixels of a tile of the tileset, and the scale the map is drawn at
+const int LEVEL_TILE_SIZE = 32;
+const double LEVEL_TILE_SCALE = 1.0;
+
+const char* const LEVEL_TILEMAP_PATH = "./assets/tilemaps/jungle.map";
+const char* const LEVEL_TILESET_PATH = "./assets/tilemaps/jungle.png";
+const char* const LEVEL_TILESET_ASSET_ID = "tilemap-image";
+
+// Tiles of the jungle tileset that block ground units (bushes and rocks)
+// The tile id is the row of the tile in the tileset * 10 + its column
+inline const std::set<int> LEVEL_SOLID_TILE_IDS = { 23, 24, 25, 26, 27, 28, 29 };
@@ -0,0 +1,41 @@
+#include "Simulation.h"
+#include "../Systems/MovementSystem.h"
+#include "../Systems/AnimationSystem.h"
+#include "../Systems/CollisionSystem.h"
+#include "../Systems/DamageSystem.h"
+#include "../Systems/KeyboardControlSystem.h"
+#include "../Systems/TileCollisionSystem.h"
+
+void Simulation::AddSystems(Registry& registry) {
+	registry.AddSystem<MovementSystem>();
+	registry.AddSystem<AnimationSystem>();
+	registry.AddSystem<CollisionSystem>();
+	registry.AddSystem<DamageSystem>();
+	registry.AddSystem<KeyboardControlSystem>();
+	registry.AddSystem<TileCollisionSystem>();
+}
+
+void Simulation::SubscribeToEvents(Registry& registry, std::unique_ptr<EventBus>& eventBus) {
+	// The collisions are handled together once the collision system is done
+	eventBus->SetQueued<CollisionEvent>(true);
+
+	registry.GetSystem<DamageSystem>().SubscribeToEvents(eventBus);
+	registry.GetSystem<KeyboardControlSystem>().SubscribeToEvents(eventBus);
+}
+
+void Simulation::Update(Registry& registry, std::unique_ptr<EventBus>& eventBus, double deltaTime) {
+	//Update the registry to process the entities that are waiting to be created/deleted
+	registry.Update();
+
+	// Emit the scheduled events that are due in this step
+	eventBus->AdvanceTimers();
+
+	// Invoke all the systems that need to update
+	registry.GetSystem<MovementSystem>().Update(deltaTime);
+	registry.GetSystem<TileCollisionSystem>().Update(eventBus);
+	registry.GetSystem<AnimationSystem>().Update();
+	registry.GetSystem<CollisionSystem>().Update(eventBus);
+
+	// Handle the events queued during the step
+	eventBus->DispatchQueuedEvents();
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <memory>
+#include "../ECS/ECS.h"
+#include "../EventBus/EventBus.h"
+
+/////////////////////////////////////////////////////////////////////////////////
+// Simulation
+/////////////////////////////////////////////////////////////////////////////////
+// The systems that make a world run and the order in which they are updated,
+// shared by the Game and by the worlds of a batch that are never drawn.
+// Everything lives in the registry and the event bus that are passed in, so
+// any number of worlds can be updated at the same time on different threads.
+/////////////////////////////////////////////////////////////////////////////////
+class Simulation {
+public:
+	static void AddSystems(Registry& registry);
+	// Once per world, the systems keep their subscriptions until they are destroyed
+	static void SubscribeToEvents(Registry& registry, std::unique_ptr<EventBus>& eventBus);
+
+	// One step: process the entities created or killed and run the systems
+	static void Update(Registry& registry, std::unique_ptr<EventBus>& eventBus, double deltaTime);
+};
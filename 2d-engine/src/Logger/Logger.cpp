@@ -5,7 +5,7 @@
 #include <ctime>
 #include <time.h>
 
-std::vector<LogEntry> Logger::messages;
+thread_local std::vector<LogEntry> Logger::messages;
 
 std::string CurrentDateTimeToString() {
     time_t now = time(0);
@@ -15,7 +15,8 @@ struct LogEntry {
 
 class Logger {
     public:
-        static std::vector<LogEntry> messages;
+        // Every thread keeps its own messages, the worlds of a batch never wait for each other to log
+        static thread_local std::vector<LogEntry> messages;
         static void Log(const std::string& message);
         static void Err(const std::string& message);
 };
\ No newline at end of file
@@ -1,11 +1,139 @@
 #include "./Game/Game.h"
+#include "./Game/LevelConfig.h"
+#include "./Tilemap/TilemapLoader.h"
+#include "./World/WorldFile.h"
+#include "./Batch/BatchRunner.h"
+#include "./Components/TransformComponent.h"
+#include "./Components/RigidBodyComponent.h"
+#include "./Components/BoxColliderComponent.h"
+#include "./Components/TilemapComponent.h"
+#include "./Systems/TileCollisionSystem.h"
+#include <random>
+#include <string>
 
 int main(int argc, char* argv[]) {
 
+    // 2d-engine --convert-map in.map out.tmap guarda el mapa en el formato binario
+    if (argc == 4 && std::string(argv[1]) == "--convert-map") {
+        Tilemap tilemap;
+        if (!TilemapLoader::Load(argv[2], tilemap, LEVEL_TILE_SIZE, LEVEL_TILE_SCALE, LEVEL_TILESET_ASSET_ID) || !TilemapLoader::SaveBinary(argv[3], tilemap)) {
+            return 1;
+        }
+        return 0;
+    }
+
+    // 2d-engine --build-world in.map out.tworld columnas filas repite el mapa hasta
+    // llenar un mundo muy grande, con un vehiculo cada cuatro chunks
+    if (argc == 6 && std::string(argv[1]) == "--build-world") {
+        Tilemap pattern;
+        if (!TilemapLoader::Load(argv[2], pattern, LEVEL_TILE_SIZE, LEVEL_TILE_SCALE, LEVEL_TILESET_ASSET_ID)) {
+            return 1;
+        }
+        const float chunkWorldSize = static_cast<float>(Tilemap::CHUNK_SIZE * LEVEL_TILE_SIZE * LEVEL_TILE_SCALE);
+        const bool isWritten = WorldFile::Write(argv[3], std::stoi(argv[4]), std::stoi(argv[5]),
+            [&](int col, int row) {
+                return pattern.GetTile(col % pattern.GetNumCols(), row % pattern.GetNumRows());
+            },
+            [&](int chunkCol, int chunkRow, std::vector<ChunkSpawn>& spawns) {
+                if ((chunkCol + chunkRow) % 4 == 0) {
+                    ChunkSpawn spawn;
+                    spawn.type = (chunkCol % 2 == 0) ? SPAWN_TANK : SPAWN_TRUCK;
+                    spawn.position = glm::vec2((chunkCol + 0.5f) * chunkWorldSize, (chunkRow + 0.5f) * chunkWorldSize);
+                    spawn.velocity = glm::vec2(spawn.type == SPAWN_TANK ? -30.0f : 20.0f, 0.0f);
+                    spawns.push_back(spawn);
+                }
+            });
+        return isWritten ? 0 : 1;
+    }
+
+    // 2d-engine --batch mundos [--ticks N] [--threads N] simula muchos mundos independientes
+    // en paralelo, todos comparten el tilemap de la jungla, e informa de los ticks por segundo
+    if (argc >= 3 && std::string(argv[1]) == "--batch") {
+        const int numWorlds = std::stoi(argv[2]);
+        int numTicks = 600;
+        int numThreads = 0;
+        for (int i = 3; i + 1 < argc; i += 2) {
+            std::string arg = argv[i];
+            if (arg == "--ticks") {
+                numTicks = std::stoi(argv[i + 1]);
+            }
+            else if (arg == "--threads") {
+                numThreads = std::stoi(argv[i + 1]);
+            }
+        }
+
+        // Datos de solo lectura compartidos por todos los mundos
+        auto tilemap = std::make_shared<Tilemap>();
+        if (!TilemapLoader::Load(LEVEL_TILEMAP_PATH, *tilemap, LEVEL_TILE_SIZE, LEVEL_TILE_SCALE, LEVEL_TILESET_ASSET_ID)) {
+            return 1;
+        }
+        auto tileCollisionLayer = TilemapLoader::BuildCollisionLayer(*tilemap, LEVEL_SOLID_TILE_IDS);
+        const float worldWidth = static_cast<float>(tilemap->GetNumCols() * LEVEL_TILE_SIZE * LEVEL_TILE_SCALE);
+        const float worldHeight = static_cast<float>(tilemap->GetNumRows() * LEVEL_TILE_SIZE * LEVEL_TILE_SCALE);
+
+        // Los logs de cada entidad creada se comerian el tiempo de los mundos
+        spdlog::set_level(spdlog::level::warn);
+
+        BatchRunner batchRunner(numThreads);
+        batchRunner.CreateWorlds(numWorlds, [&](int worldIndex, Registry& registry, std::unique_ptr<EventBus>&) {
+            registry.GetSystem<TileCollisionSystem>().SetTileCollisionLayer(tileCollisionLayer);
+            Entity map = registry.CreateEntity();
+            map.AddComponent<TilemapComponent>(tilemap, tileCollisionLayer);
+
+            std::mt19937 random(worldIndex);
+            std::uniform_real_distribution<float> x(0.0f, worldWidth);
+            std::uniform_real_distribution<float> y(0.0f, worldHeight);
+            std::uniform_real_distribution<float> speed(-60.0f, 60.0f);
+            for (int i = 0; i < 32; i++) {
+                Entity vehicle = registry.CreateEntity();
+                vehicle.AddComponent<TransformComponent>(glm::vec2(x(random), y(random)), glm::vec2(1.0, 1.0), 0.0);
+                vehicle.AddComponent<RigidBodyComponent>(glm::vec2(speed(random), speed(random)));
+                vehicle.AddComponent<BoxColliderComponent>(32, 32);
+            }
+        });
+
+        const BatchRunner::BatchResult result = batchRunner.Run(numTicks, 1.0 / DEFAULT_TICK_RATE);
+        spdlog::set_level(spdlog::level::info);
+        spdlog::info("{0} worlds x {1} ticks on {2} threads in {3:.3f} s, {4:.0f} world ticks/s",
+            result.numWorlds, result.numTicks, result.numThreads, result.seconds, result.worldTicksPerSecond);
+        return 0;
+    }
+
     // Si no se utiliza "new" al crear la instancia, se guarda
     // en el stack y se borra de la memoria al acabar el scope
     Game game; 
 
+    // 2d-engine --headless [--tick-rate N] [--unpaced] [--ticks N] simula sin ventana ni renderer,
+    // a la frecuencia indicada o tan rapido como se pueda, y termina tras N ticks si se indica.
+    // --unpaced implica --headless, sin ritmo fijo no se publica ningun frame para la ventana.
+    // Con --profile fichero.json se perfila toda la ejecucion y se guarda como traza de Chrome.
+    // Con --record fichero.trec se graban las teclas y los eventos de cada tick, y con
+    // --replay fichero.trec se reproduce la sesion grabada sin ventana y tan rapido como se pueda
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--headless") {
+            game.SetHeadless(true);
+        }
+        else if (arg == "--unpaced") {
+            game.SetUnpaced(true);
+        }
+        else if (arg == "--tick-rate" && i + 1 < argc) {
+            game.SetTickRate(std::stoi(argv[++i]));
+        }
+        else if (arg == "--ticks" && i + 1 < argc) {
+            game.SetMaxTicks(std::stoi(argv[++i]));
+        }
+        else if (arg == "--profile" && i + 1 < argc) {
+            game.SetProfilePath(argv[++i]);
+        }
+        else if (arg == "--record" && i + 1 < argc) {
+            game.SetRecordPath(argv[++i]);
+        }
+        else if (arg == "--replay" && i + 1 < argc) {
+            game.SetReplayPath(argv[++i]);
+        }
+    }
+
     game.Initialize();
     game.Run();
     game.Destroy();
@@ -0,0 +1,188 @@
+#include "Profiler.h"
+#include <fstream>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+std::atomic<int> Profiler::recordingFlags { 0 };
+std::atomic<unsigned int> Profiler::generation { 0 };
+int64_t Profiler::captureStartTicks = 0;
+std::chrono::steady_clock::time_point Profiler::captureStartTime;
+double Profiler::captureNanosecondsPerTick = 1.0;
+const int64_t Profiler::referenceTicks = Profiler::ReadTicks();
+const std::chrono::steady_clock::time_point Profiler::referenceTime = std::chrono::steady_clock::now();
+std::mutex Profiler::buffersMutex;
+std::vector<std::unique_ptr<Profiler::ThreadBuffer>> Profiler::buffers;
+constexpr size_t Profiler::EVENTS_PER_THREAD;
+
+void Profiler::StartCapture() {
+	generation.fetch_add(1);
+	captureStartTime = std::chrono::steady_clock::now();
+	captureStartTicks = ReadTicks();
+	recordingFlags.fetch_or(RECORDING_CAPTURE);
+	spdlog::info("Profiler capture started");
+}
+
+void Profiler::StopCapture() {
+	recordingFlags.fetch_and(~RECORDING_CAPTURE);
+#if PROFILER_USE_TSC
+	// The counter is calibrated against the steady clock over the capture itself
+	const int64_t ticks = ReadTicks() - captureStartTicks;
+	const double nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - captureStartTime).count();
+	captureNanosecondsPerTick = ticks > 0 ? nanoseconds / ticks : GetNanosecondsPerTick();
+#endif
+	spdlog::info("Profiler capture stopped");
+}
+
+void Profiler::SetCollectingTimings(bool isCollectingTimings) {
+	if (isCollectingTimings) {
+		recordingFlags.fetch_or(RECORDING_TIMINGS);
+	}
+	else {
+		recordingFlags.fetch_and(~RECORDING_TIMINGS);
+	}
+}
+
+void Profiler::TakeThreadTimings(std::vector<ScopeTiming>& timings) {
+	ThreadBuffer& buffer = GetThreadBuffer();
+	timings.clear();
+	timings.swap(buffer.timings);
+	std::sort(timings.begin(), timings.end(), [](const ScopeTiming& a, const ScopeTiming& b) {
+		return a.ticks > b.ticks;
+	});
+}
+
+double Profiler::GetNanosecondsPerTick() {
+#if PROFILER_USE_TSC
+	const double nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - referenceTime).count();
+	const int64_t ticks = ReadTicks() - referenceTicks;
+	return ticks > 0 ? nanoseconds / ticks : 1.0;
+#else
+	return 1.0;
+#endif
+}
+
+Profiler::ThreadBuffer* Profiler::CreateThreadBuffer() {
+	auto buffer = std::make_unique<ThreadBuffer>();
+
+	std::lock_guard<std::mutex> lock(buffersMutex);
+	buffer->threadId = static_cast<int>(buffers.size()) + 1;
+	buffer->threadName = "Thread " + std::to_string(buffer->threadId);
+	buffers.push_back(std::move(buffer));
+	return buffers.back().get();
+}
+
+Profiler::ThreadBuffer& Profiler::GetThreadBuffer() {
+	// Created the first time the thread records something
+	if (!threadBuffer) {
+		threadBuffer = CreateThreadBuffer();
+	}
+	return *threadBuffer;
+}
+
+void Profiler::RecordSlow(const char* name, int64_t startTicks, int64_t endTicks) {
+	ThreadBuffer& buffer = GetThreadBuffer();
+	const int flags = recordingFlags.load(std::memory_order_relaxed);
+
+	if (flags & RECORDING_TIMINGS) {
+		auto timing = std::find_if(buffer.timings.begin(), buffer.timings.end(), [name](const ScopeTiming& timing) {
+			return timing.name == name;
+		});
+		if (timing != buffer.timings.end()) {
+			timing->ticks += endTicks - startTicks;
+			timing->count++;
+		}
+		else {
+			buffer.timings.push_back({ name, endTicks - startTicks, 1 });
+		}
+	}
+	if (!(flags & RECORDING_CAPTURE)) {
+		return;
+	}
+
+	const unsigned int currentGeneration = generation.load(std::memory_order_relaxed);
+	if (buffer.generation.load(std::memory_order_relaxed) != currentGeneration) {
+		if (buffer.events.empty()) {
+			buffer.events.resize(EVENTS_PER_THREAD);
+		}
+		buffer.numEvents.store(0, std::memory_order_relaxed);
+		buffer.numDropped = 0;
+		// The exporter only reads the buffers of the current capture, released after they are allocated
+		buffer.generation.store(currentGeneration, std::memory_order_release);
+	}
+
+	const size_t index = buffer.numEvents.load(std::memory_order_relaxed);
+	if (index >= buffer.events.size()) {
+		buffer.numDropped++;
+		return;
+	}
+	buffer.events[index] = { name, startTicks, endTicks };
+	buffer.numEvents.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::SetThreadName(const std::string& threadName) {
+	ThreadBuffer& buffer = GetThreadBuffer();
+	std::lock_guard<std::mutex> lock(buffersMutex);
+	buffer.threadName = threadName;
+}
+
+// Names are literals or function names, but the quotes and backslashes are escaped anyway
+static void WriteJsonString(std::ofstream& file, const std::string& text) {
+	file << '"';
+	for (char ch : text) {
+		if (ch == '"' || ch == '\\') {
+			file << '\\';
+		}
+		file << ch;
+	}
+	file << '"';
+}
+
+bool Profiler::WriteChromeTrace(const std::string& filePath) {
+	std::ofstream file(filePath);
+	if (!file) {
+		spdlog::error("Error creating the profiler trace {0}", filePath);
+		return false;
+	}
+
+	file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+	bool isFirst = true;
+	size_t numEvents = 0;
+	size_t numDropped = 0;
+
+	// The names of the threads, as metadata events
+	{
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		for (const auto& buffer : buffers) {
+			file << (isFirst ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId << ",\"args\":{\"name\":";
+			WriteJsonString(file, buffer->threadName);
+			file << "}}";
+			isFirst = false;
+			if (buffer->generation.load() == generation.load()) {
+				numDropped += buffer->numDropped;
+			}
+		}
+	}
+
+	// Complete events, the timestamps are in microseconds since the capture started
+	const double microsecondsPerTick = captureNanosecondsPerTick / 1000.0;
+	file.precision(3);
+	file << std::fixed;
+	ForEachEvent([&](const ThreadBuffer& buffer, const ProfileEvent& event) {
+		file << (isFirst ? "" : ",\n") << "{\"name\":";
+		WriteJsonString(file, event.name);
+		file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer.threadId
+			<< ",\"ts\":" << (event.startTicks - captureStartTicks) * microsecondsPerTick
+			<< ",\"dur\":" << (event.endTicks - event.startTicks) * microsecondsPerTick << "}";
+		isFirst = false;
+		numEvents++;
+	});
+	file << "\n]}\n";
+
+	if (!file) {
+		spdlog::error("Error writing the profiler trace {0}", filePath);
+		return false;
+	}
+	spdlog::info("Profiler trace {0} written with {1} events, {2} dropped", filePath, numEvents, numDropped);
+	return true;
+}
@@ -0,0 +1,207 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Set PROFILER_ENABLED to 0 to compile every profiling marker out of the build
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+// The time stamp counter is read in a few cycles, much cheaper than the system clock
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define PROFILER_USE_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PROFILER_USE_TSC 1
+#else
+#define PROFILER_USE_TSC 0
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////
+// Profiler
+/////////////////////////////////////////////////////////////////////////////////
+// Records the time spent in the scopes marked with PROFILE_SCOPE while a
+// capture is running. Every thread writes into a buffer of its own, so a
+// marker never takes a lock: it reads the clock twice and stores one event.
+// A thread allocates its event buffer the first time it records in a capture,
+// the threads that never profile take no memory for it.
+// On x86 the clock is the time stamp counter. The trace converts it to
+// nanoseconds with the steady clock readings taken when the capture starts
+// and stops, the live timings with one taken when the program starts.
+// Nested scopes are nested in time, so the hierarchy is rebuilt by the viewer.
+// The capture is exported in the Chrome trace event format, open it with
+// chrome://tracing or https://ui.perfetto.dev
+//
+// The same markers can also add up the time of every scope per thread, the
+// debug overlay shows those totals live without running a capture.
+/////////////////////////////////////////////////////////////////////////////////
+class Profiler {
+public:
+	struct ProfileEvent {
+		// Must point to a string that outlives the capture, usually a literal
+		const char* name;
+		int64_t startTicks;
+		int64_t endTicks;
+	};
+
+	// Time spent in a scope since the thread took its timings the last time
+	struct ScopeTiming {
+		const char* name;
+		int64_t ticks;
+		int count;
+	};
+
+	// Events of a thread, written only by that thread
+	struct ThreadBuffer {
+		// Empty until the thread records in a capture
+		std::vector<ProfileEvent> events;
+		// Only read by the thread too, there are just a few scope names
+		std::vector<ScopeTiming> timings;
+		std::atomic<size_t> numEvents { 0 };
+		std::atomic<unsigned int> generation { 0 };
+		size_t numDropped = 0;
+		int threadId = 0;
+		std::string threadName;
+	};
+
+private:
+	// Both modes share a flag word, a marker checks it with a single load
+	enum RecordingFlags {
+		RECORDING_CAPTURE = 1 << 0,
+		RECORDING_TIMINGS = 1 << 1
+	};
+	static std::atomic<int> recordingFlags;
+
+	// Increased by every capture, a thread clears its buffer when it sees a new one
+	static std::atomic<unsigned int> generation;
+	// Ticks when the last capture started, the origin of the trace
+	static int64_t captureStartTicks;
+	static std::chrono::steady_clock::time_point captureStartTime;
+	// Measured over the last capture, when it stops
+	static double captureNanosecondsPerTick;
+
+	// Clock readings when the program started, to convert the ticks
+	static const int64_t referenceTicks;
+	static const std::chrono::steady_clock::time_point referenceTime;
+
+	// The buffers outlive their threads, the capture can be exported after they end
+	static std::mutex buffersMutex;
+	static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+	// Constant initialized, so a marker reads it without a thread_local guard
+	inline static thread_local ThreadBuffer* threadBuffer = nullptr;
+
+	static ThreadBuffer* CreateThreadBuffer();
+	// Everything that is not a plain event of the current capture: timings, a new capture or a full buffer
+	static void RecordSlow(const char* name, int64_t startTicks, int64_t endTicks);
+
+public:
+	// Events kept per thread and capture, the rest are dropped
+	static constexpr size_t EVENTS_PER_THREAD = 1 << 18;
+
+	static void StartCapture();
+	static void StopCapture();
+	static bool IsCapturing() {
+		return (recordingFlags.load(std::memory_order_relaxed) & RECORDING_CAPTURE) != 0;
+	}
+	static bool IsRecording() {
+		return recordingFlags.load(std::memory_order_relaxed) != 0;
+	}
+
+	// Add up the time of every scope per thread, see TakeThreadTimings
+	static void SetCollectingTimings(bool isCollectingTimings);
+	static bool IsCollectingTimings() {
+		return (recordingFlags.load(std::memory_order_relaxed) & RECORDING_TIMINGS) != 0;
+	}
+	// Moves the totals of the calling thread into timings, sorted by time, and starts again from zero
+	static void TakeThreadTimings(std::vector<ScopeTiming>& timings);
+
+	static int64_t ReadTicks() {
+#if PROFILER_USE_TSC
+		return static_cast<int64_t>(__rdtsc());
+#else
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+	}
+
+	// Nanoseconds per tick measured since the program started
+	static double GetNanosecondsPerTick();
+
+	static ThreadBuffer& GetThreadBuffer();
+
+	static void Record(const char* name, int64_t startTicks, int64_t endTicks) {
+		// Inlined in the markers: only capturing, into the buffer of the current capture with room left
+		ThreadBuffer* buffer = threadBuffer;
+		if (buffer && recordingFlags.load(std::memory_order_relaxed) == RECORDING_CAPTURE &&
+			buffer->generation.load(std::memory_order_relaxed) == generation.load(std::memory_order_relaxed)) {
+			const size_t index = buffer->numEvents.load(std::memory_order_relaxed);
+			if (index < EVENTS_PER_THREAD) {
+				buffer->events[index] = { name, startTicks, endTicks };
+				buffer->numEvents.store(index + 1, std::memory_order_release);
+				return;
+			}
+		}
+		RecordSlow(name, startTicks, endTicks);
+	}
+
+	// Name shown for the calling thread in the trace
+	static void SetThreadName(const std::string& threadName);
+
+	// Call it once the capture is stopped
+	static bool WriteChromeTrace(const std::string& filePath);
+
+	// Visit the events of the last capture of every thread, call it once the capture is stopped
+	template <typename TFunction>
+	static void ForEachEvent(TFunction function);
+};
+
+// Measures the time from its construction to its destruction
+class ProfileScope {
+private:
+	const char* name;
+	int64_t startTicks;
+
+public:
+	explicit ProfileScope(const char* name): name(name), startTicks(Profiler::IsRecording() ? Profiler::ReadTicks() : -1) {}
+
+	~ProfileScope() {
+		if (startTicks >= 0) {
+			Profiler::Record(name, startTicks, Profiler::ReadTicks());
+		}
+	}
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator =(const ProfileScope&) = delete;
+};
+
+template <typename TFunction>
+void Profiler::ForEachEvent(TFunction function) {
+	const unsigned int currentGeneration = generation.load();
+	std::lock_guard<std::mutex> lock(buffersMutex);
+	for (const auto& buffer : buffers) {
+		if (buffer->generation.load() != currentGeneration) {
+			continue;
+		}
+		const size_t numEvents = buffer->numEvents.load(std::memory_order_acquire);
+		for (size_t i = 0; i < numEvents; i++) {
+			function(*buffer, buffer->events[i]);
+		}
+	}
+}
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if PROFILER_ENABLED
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_FUNCTION()
+#endif
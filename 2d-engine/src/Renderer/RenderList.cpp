@@ -0,0 +1,102 @@
+#include "RenderList.h"
+#include <algorithm>
+
+RenderList::Layer& RenderList::GetOrCreateLayer(int zIndex) {
+	auto layer = std::lower_bound(layers.begin(), layers.end(), zIndex, [](const Layer& layer, int zIndex) {
+		return layer.zIndex < zIndex;
+	});
+	if (layer == layers.end() || layer->zIndex != zIndex) {
+		Layer newLayer;
+		newLayer.zIndex = zIndex;
+		layer = layers.insert(layer, std::move(newLayer));
+	}
+	return *layer;
+}
+
+void RenderList::Insert(Entity entity, int zIndex, const SDL_FRect& bounds, bool isFixed) {
+	const auto entityId = entity.GetId();
+	if (entityId >= static_cast<int>(entries.size())) {
+		entries.resize(entityId + 1);
+	}
+	if (entries[entityId].isInList) {
+		Remove(entity);
+	}
+
+	registry = entity.registry;
+
+	auto& entry = entries[entityId];
+	entry.zIndex = zIndex;
+	entry.sequence = nextSequence++;
+	entry.bounds = bounds;
+	entry.isFixed = isFixed;
+	entry.isInList = true;
+
+	auto& layer = GetOrCreateLayer(zIndex);
+	layer.entities.push_back(entity);
+	if (isFixed) {
+		layer.fixedEntities.push_back(entity);
+	}
+	else {
+		layer.grid.Insert(entityId, bounds);
+	}
+}
+
+void RenderList::Remove(Entity entity) {
+	if (!Contains(entity)) {
+		return;
+	}
+	const auto entityId = entity.GetId();
+	auto& entry = entries[entityId];
+	auto& layer = GetOrCreateLayer(entry.zIndex);
+
+	// Erase instead of swapping with the last one, the order inside the bucket must be kept
+	layer.entities.erase(std::find(layer.entities.begin(), layer.entities.end(), entity));
+	if (entry.isFixed) {
+		layer.fixedEntities.erase(std::find(layer.fixedEntities.begin(), layer.fixedEntities.end(), entity));
+	}
+	else {
+		layer.grid.Remove(entityId);
+	}
+	entry.isInList = false;
+}
+
+void RenderList::Rebucket(Entity entity, int zIndex) {
+	if (!Contains(entity) || entries[entity.GetId()].zIndex == zIndex) {
+		return;
+	}
+	const auto entry = entries[entity.GetId()];
+	Remove(entity);
+	Insert(entity, zIndex, entry.bounds, entry.isFixed);
+}
+
+void RenderList::UpdateBounds(Entity entity, const SDL_FRect& bounds) {
+	if (!Contains(entity)) {
+		return;
+	}
+	auto& entry = entries[entity.GetId()];
+	entry.bounds = bounds;
+	if (!entry.isFixed) {
+		GetOrCreateLayer(entry.zIndex).grid.Update(entity.GetId(), bounds);
+	}
+}
+
+bool RenderList::Contains(Entity entity) const {
+	const auto entityId = entity.GetId();
+	return entityId < static_cast<int>(entries.size()) && entries[entityId].isInList;
+}
+
+int RenderList::GetZIndex(Entity entity) const {
+	return entries[entity.GetId()].zIndex;
+}
+
+size_t RenderList::GetSize() const {
+	size_t size = 0;
+	for (const auto& layer : layers) {
+		size += layer.entities.size();
+	}
+	return size;
+}
+
+size_t RenderList::GetNumLayers() const {
+	return layers.size();
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include "../ECS/ECS.h"
+#include "../Spatial/SpatialHashGrid.h"
+#include <SDL.h>
+#include <algorithm>
+#include <vector>
+
+/////////////////////////////////////////////////////////////////////////////////
+// RenderList
+/////////////////////////////////////////////////////////////////////////////////
+// Persistent draw order of the renderable entities. Entities are kept in one
+// bucket per z-index (a radix-style sort by layer), in insertion order inside
+// every bucket. An entity is only moved when it is added, removed, or its
+// z-index changes, so nothing is sorted or copied every frame.
+// Every bucket also indexes the bounds of its entities in a spatial grid, so
+// drawing only the visible part of the world costs what is visible.
+/////////////////////////////////////////////////////////////////////////////////
+class RenderList {
+private:
+	struct Layer {
+		int zIndex;
+		std::vector<Entity> entities;
+		// World space entities of the layer
+		SpatialHashGrid grid;
+		// Screen space entities of the layer, few and always tested
+		std::vector<Entity> fixedEntities;
+	};
+
+	struct Entry {
+		int zIndex = 0;
+		// Insertion order, the entities of a bucket are always sorted by it
+		unsigned int sequence = 0;
+		SDL_FRect bounds = { 0, 0, 0, 0 };
+		bool isFixed = false;
+		bool isInList = false;
+	};
+
+	// Registry of the entities, to hand out entities built from the indexed ids
+	Registry* registry = nullptr;
+
+	// Buckets sorted by z-index, there are only a handful of them
+	std::vector<Layer> layers;
+
+	// [index = entity id]
+	std::vector<Entry> entries;
+	unsigned int nextSequence = 0;
+
+	// Scratch buffer of the visible entity ids, reused every frame
+	std::vector<int> visibleIds;
+
+	Layer& GetOrCreateLayer(int zIndex);
+
+public:
+	RenderList() = default;
+
+	void Insert(Entity entity, int zIndex, const SDL_FRect& bounds, bool isFixed = false);
+	void Remove(Entity entity);
+
+	// Move the entity to the end of the bucket of its new z-index
+	void Rebucket(Entity entity, int zIndex);
+
+	// Let the spatial index know that the entity moved or changed its size
+	void UpdateBounds(Entity entity, const SDL_FRect& bounds);
+
+	bool Contains(Entity entity) const;
+	int GetZIndex(Entity entity) const;
+	size_t GetSize() const;
+	size_t GetNumLayers() const;
+
+	// Visit all the entities back to front
+	template <typename TFunction>
+	void ForEach(TFunction function) const;
+
+	// Visit back to front only the world entities inside viewRect and the fixed entities inside screenRect
+	template <typename TFunction>
+	void ForEachVisible(const SDL_FRect& viewRect, const SDL_FRect& screenRect, TFunction function);
+};
+
+template <typename TFunction>
+void RenderList::ForEach(TFunction function) const {
+	for (const auto& layer : layers) {
+		for (const auto& entity : layer.entities) {
+			function(entity, layer.zIndex);
+		}
+	}
+}
+
+template <typename TFunction>
+void RenderList::ForEachVisible(const SDL_FRect& viewRect, const SDL_FRect& screenRect, TFunction function) {
+	for (auto& layer : layers) {
+		if (layer.entities.empty()) {
+			continue;
+		}
+		visibleIds.clear();
+		layer.grid.Query(viewRect, visibleIds);
+		for (const auto& entity : layer.fixedEntities) {
+			const auto& bounds = entries[entity.GetId()].bounds;
+			if (bounds.x < screenRect.x + screenRect.w && bounds.x + bounds.w > screenRect.x &&
+				bounds.y < screenRect.y + screenRect.h && bounds.y + bounds.h > screenRect.y) {
+				visibleIds.push_back(entity.GetId());
+			}
+		}
+
+		// The grid returns the entities in cell order, put them back in the order of the bucket
+		std::sort(visibleIds.begin(), visibleIds.end(), [this](int a, int b) {
+			return entries[a].sequence < entries[b].sequence;
+		});
+
+		for (int entityId : visibleIds) {
+			Entity entity(entityId);
+			entity.registry = registry;
+			function(entity, layer.zIndex);
+		}
+	}
+}
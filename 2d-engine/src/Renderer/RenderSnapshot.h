@@ -0,0 +1,78 @@
+#pragma once
+#include <SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include "../Camera/Camera.h"
+#include "../Tilemap/Tilemap.h"
+#include "../Debug/DebugStats.h"
+
+// A sprite ready to be drawn, the texture is resolved from the handle by the render thread
+struct SpriteCommand {
+	int textureHandle;
+	// Relative to the image of the asset, not to its atlas page
+	SDL_Rect srcRect;
+	SDL_FRect dstRect;
+	float rotation;
+	// Top left corner of the dstRect at the start of the simulation step
+	glm::vec2 previousDstPosition;
+	float previousRotation;
+	int zIndex;
+};
+
+// A debug collider outline in world coordinates, drawn with the interpolated camera like the sprites
+struct ColliderCommand {
+	glm::vec2 position;
+	// Top left corner at the start of the simulation step
+	glm::vec2 previousPosition;
+	float width;
+	float height;
+};
+
+/////////////////////////////////////////////////////////////////////////////////
+// RenderSnapshot
+/////////////////////////////////////////////////////////////////////////////////
+// Everything the render thread needs to draw a frame, copied out of the
+// registry by the simulation so drawing never touches the components.
+// The sprites are already culled and sorted back to front, and by texture
+// inside the same z-index so they batch. Both the previous and the current
+// state of the step are kept, the renderer interpolates them by the time
+// passed since the snapshot was published.
+/////////////////////////////////////////////////////////////////////////////////
+struct RenderSnapshot {
+	Camera camera;
+	glm::vec2 previousCameraPosition = glm::vec2(0.0);
+
+	// Length of the simulation step and when it ended
+	double stepSeconds = 0.0;
+	std::chrono::steady_clock::time_point publishTime;
+
+	// The chunks are baked and drawn by the render thread
+	std::vector<Tilemap> tilemaps;
+	std::vector<SpriteCommand> sprites;
+	// Debug outlines of the colliders
+	std::vector<ColliderCommand> colliders;
+
+	// Only filled while the debug overlay is visible
+	bool hasDebugStats = false;
+	DebugStats debugStats;
+
+	// Keeps the capacity of the vectors, the snapshots are reused every frame
+	// 0 shows the previous state of the step and 1 the current one
+	float GetInterpolation(std::chrono::steady_clock::time_point now) const {
+		if (stepSeconds <= 0.0) {
+			return 1.0f;
+		}
+		const double elapsed = std::chrono::duration<double>(now - publishTime).count();
+		return static_cast<float>(std::min(1.0, std::max(0.0, elapsed / stepSeconds)));
+	}
+
+	void Clear() {
+		tilemaps.clear();
+		sprites.clear();
+		colliders.clear();
+		hasDebugStats = false;
+		debugStats.Clear();
+	}
+};
@@ -0,0 +1,82 @@
+#include "SnapshotRenderer.h"
+#include <iterator>
+
+void SnapshotRenderer::Render(SDL_Renderer* renderer, const AssetStore& assetStore, const RenderSnapshot& snapshot, const Camera& camera, float interpolation) {
+	// The tilemaps are the background, they are drawn under every sprite
+	numChunksDrawn = 0;
+	for (const auto& tilemap : snapshot.tilemaps) {
+		auto& tilemapRenderer = tilemapRenderers[tilemap.GetId()];
+		if (!tilemapRenderer) {
+			tilemapRenderer = std::make_unique<TilemapRenderer>();
+		}
+		tilemapRenderer->Render(renderer, tilemap, assetStore, camera);
+		numChunksDrawn += tilemapRenderer->GetNumChunksDrawn();
+	}
+
+	// Forget the tilemaps that are gone or have been resized
+	if (tilemapRenderers.size() > snapshot.tilemaps.size()) {
+		for (auto it = tilemapRenderers.begin(); it != tilemapRenderers.end();) {
+			bool isInSnapshot = false;
+			for (const auto& tilemap : snapshot.tilemaps) {
+				isInSnapshot = isInSnapshot || tilemap.GetId() == it->first;
+			}
+			it = isInSnapshot ? std::next(it) : tilemapRenderers.erase(it);
+		}
+	}
+
+	// Consecutive sprites that share a texture are submitted in a single draw call
+	spriteBatch.Begin(renderer);
+	for (const auto& sprite : snapshot.sprites) {
+		// The sprite source rectangle is relative to its image, move it to where the image is in the atlas page
+		const auto& region = assetStore.GetTextureRegion(sprite.textureHandle);
+		SDL_Rect srcRect = sprite.srcRect;
+		if (region.isLoaded) {
+			srcRect.x += region.rect.x;
+			srcRect.y += region.rect.y;
+		}
+		else {
+			// Still loading, the placeholder is stretched over the sprite
+			srcRect = region.rect;
+		}
+
+		SDL_FRect dstRect = sprite.dstRect;
+		dstRect.x = sprite.previousDstPosition.x + (dstRect.x - sprite.previousDstPosition.x) * interpolation;
+		dstRect.y = sprite.previousDstPosition.y + (dstRect.y - sprite.previousDstPosition.y) * interpolation;
+		const float rotation = sprite.previousRotation + (sprite.rotation - sprite.previousRotation) * interpolation;
+		spriteBatch.Draw(region.texture, srcRect, dstRect, rotation);
+	}
+	spriteBatch.End();
+
+	if (!snapshot.colliders.empty()) {
+		// Interpolated like the sprites, so the outlines do not lag behind them
+		colliderRects.clear();
+		for (const auto& collider : snapshot.colliders) {
+			const glm::vec2 screenPosition = camera.WorldToScreen(glm::mix(collider.previousPosition, collider.position, interpolation));
+			colliderRects.push_back({ screenPosition.x, screenPosition.y, collider.width, collider.height });
+		}
+		SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
+		SDL_RenderDrawRectsF(renderer, colliderRects.data(), static_cast<int>(colliderRects.size()));
+	}
+}
+
+void SnapshotRenderer::Invalidate() {
+	for (auto& tilemapRenderer : tilemapRenderers) {
+		tilemapRenderer.second->Invalidate();
+	}
+}
+
+void SnapshotRenderer::Clear() {
+	tilemapRenderers.clear();
+}
+
+int SnapshotRenderer::GetNumDrawCalls() const {
+	return spriteBatch.GetNumDrawCalls();
+}
+
+int SnapshotRenderer::GetNumSprites() const {
+	return spriteBatch.GetNumSprites();
+}
+
+int SnapshotRenderer::GetNumChunksDrawn() const {
+	return numChunksDrawn;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <SDL.h>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "RenderSnapshot.h"
+#include "SpriteBatch.h"
+#include "../AssetStore/AssetStore.h"
+#include "../Tilemap/TilemapRenderer.h"
+
+/////////////////////////////////////////////////////////////////////////////////
+// SnapshotRenderer
+/////////////////////////////////////////////////////////////////////////////////
+// Draws a RenderSnapshot on the render thread: the tilemaps with their baked
+// chunks, the sprites in a SpriteBatch and the debug colliders. It owns every
+// texture created while drawing, so it must be cleared before the renderer
+// is destroyed.
+/////////////////////////////////////////////////////////////////////////////////
+class SnapshotRenderer {
+private:
+	SpriteBatch spriteBatch;
+
+	// Baked chunks of every tilemap of the snapshots, by tilemap id
+	std::unordered_map<unsigned int, std::unique_ptr<TilemapRenderer>> tilemapRenderers;
+
+	int numChunksDrawn = 0;
+
+	// Screen rectangles of the debug colliders, reused every frame
+	std::vector<SDL_FRect> colliderRects;
+
+public:
+	SnapshotRenderer() = default;
+
+	// Draws the snapshot between its previous and its current state, the camera is already interpolated
+	void Render(SDL_Renderer* renderer, const AssetStore& assetStore, const RenderSnapshot& snapshot, const Camera& camera, float interpolation);
+
+	// The content of the render targets has been lost, bake everything again
+	void Invalidate();
+
+	// Destroy the chunk textures, must be called before the renderer is destroyed
+	void Clear();
+
+	int GetNumDrawCalls() const;
+	int GetNumSprites() const;
+	int GetNumChunksDrawn() const;
+};
@@ -0,0 +1,108 @@
+#include "SpriteBatch.h"
+#include <cmath>
+
+const double DEGREES_TO_RADIANS = 3.14159265358979323846 / 180.0;
+
+void SpriteBatch::Begin(SDL_Renderer* renderer) {
+	this->renderer = renderer;
+	currentTexture = nullptr;
+	vertices.clear();
+	indices.clear();
+	numSprites = 0;
+	numDrawCalls = 0;
+}
+
+void SpriteBatch::Draw(SDL_Texture* texture, const SDL_Rect& srcRect, const SDL_FRect& dstRect, double rotation) {
+	if (!texture) {
+		return;
+	}
+	numSprites++;
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	// Every texture switch breaks the batch
+	if (texture != currentTexture) {
+		Flush();
+		currentTexture = texture;
+		int width, height;
+		SDL_QueryTexture(texture, NULL, NULL, &width, &height);
+		textureWidth = static_cast<float>(width);
+		textureHeight = static_cast<float>(height);
+	}
+
+	// Corners of the quad relative to its center, rotated on the CPU
+	const float halfWidth = dstRect.w * 0.5f;
+	const float halfHeight = dstRect.h * 0.5f;
+	const float centerX = dstRect.x + halfWidth;
+	const float centerY = dstRect.y + halfHeight;
+	float cosine = 1.0f;
+	float sine = 0.0f;
+	if (rotation != 0.0) {
+		const double radians = rotation * DEGREES_TO_RADIANS;
+		cosine = static_cast<float>(std::cos(radians));
+		sine = static_cast<float>(std::sin(radians));
+	}
+
+	const float u0 = srcRect.x / textureWidth;
+	const float v0 = srcRect.y / textureHeight;
+	const float u1 = (srcRect.x + srcRect.w) / textureWidth;
+	const float v1 = (srcRect.y + srcRect.h) / textureHeight;
+
+	const float cornersX[4] = { -halfWidth, halfWidth, halfWidth, -halfWidth };
+	const float cornersY[4] = { -halfHeight, -halfHeight, halfHeight, halfHeight };
+	const float cornersU[4] = { u0, u1, u1, u0 };
+	const float cornersV[4] = { v0, v0, v1, v1 };
+
+	const int firstVertex = static_cast<int>(vertices.size());
+	for (int i = 0; i < 4; i++) {
+		SDL_Vertex vertex;
+		vertex.position.x = centerX + cornersX[i] * cosine - cornersY[i] * sine;
+		vertex.position.y = centerY + cornersX[i] * sine + cornersY[i] * cosine;
+		vertex.color = { 255, 255, 255, 255 };
+		vertex.tex_coord.x = cornersU[i];
+		vertex.tex_coord.y = cornersV[i];
+		vertices.push_back(vertex);
+	}
+
+	// Two triangles per quad
+	const int quadIndices[6] = { 0, 1, 2, 0, 2, 3 };
+	for (int index : quadIndices) {
+		indices.push_back(firstVertex + index);
+	}
+#else
+	// Without SDL_RenderGeometry (SDL < 2.0.18) every sprite is its own draw call
+	SDL_RenderCopyExF(renderer, texture, &srcRect, &dstRect, rotation, NULL, SDL_FLIP_NONE);
+	numDrawCalls++;
+#endif
+}
+
+void SpriteBatch::End() {
+	Flush();
+	currentTexture = nullptr;
+}
+
+void SpriteBatch::Flush() {
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	if (indices.empty()) {
+		return;
+	}
+	SDL_RenderGeometry(
+		renderer,
+		currentTexture,
+		vertices.data(),
+		static_cast<int>(vertices.size()),
+		indices.data(),
+		static_cast<int>(indices.size())
+	);
+	numDrawCalls++;
+	vertices.clear();
+	indices.clear();
+#endif
+}
+
+int SpriteBatch::GetNumSprites() const {
+	return numSprites;
+}
+
+int SpriteBatch::GetNumDrawCalls() const {
+	return numDrawCalls;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+
+/////////////////////////////////////////////////////////////////////////////////
+// SpriteBatch
+/////////////////////////////////////////////////////////////////////////////////
+// Accumulates the quads of consecutive sprites that share a texture into one 
+// vertex and index array, and submits them with a single SDL_RenderGeometry.
+// Rotation and scale are applied on the CPU, so a new draw call is only needed
+// when the texture changes. Works with any SDL renderer, including software.
+/////////////////////////////////////////////////////////////////////////////////
+class SpriteBatch {
+private:
+	SDL_Renderer* renderer = nullptr;
+	SDL_Texture* currentTexture = nullptr;
+	float textureWidth = 1.0f;
+	float textureHeight = 1.0f;
+
+	std::vector<SDL_Vertex> vertices;
+	std::vector<int> indices;
+
+	int numSprites = 0;
+	int numDrawCalls = 0;
+
+	void Flush();
+
+public:
+	SpriteBatch() = default;
+
+	// Start a new batch, the draw counters are reset
+	void Begin(SDL_Renderer* renderer);
+
+	// Queue a sprite, rotation is in degrees clockwise around the center of dstRect like SDL_RenderCopyEx
+	void Draw(SDL_Texture* texture, const SDL_Rect& srcRect, const SDL_FRect& dstRect, double rotation = 0.0);
+
+	// Submit whatever is still pending
+	void End();
+
+	int GetNumSprites() const;
+	int GetNumDrawCalls() const;
+};
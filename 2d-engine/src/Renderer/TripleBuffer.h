@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+/////////////////////////////////////////////////////////////////////////////////
+// TripleBuffer
+/////////////////////////////////////////////////////////////////////////////////
+// Hands values from one producer thread to one consumer thread. The producer
+// fills the back buffer and publishes it, the consumer takes the latest
+// published one. The buffers are swapped with a single atomic exchange and
+// neither side ever waits for the other, a value not taken before the next
+// publish is simply replaced. A mutex is only used to wake a sleeping consumer.
+/////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+class TripleBuffer {
+private:
+	// Index of the buffer in the middle, the NEW_BIT is set if it has not been taken
+	static constexpr int NEW_BIT = 4;
+
+	T buffers[3];
+	int backIndex = 0;
+	std::atomic<int> middle { 1 };
+	int frontIndex = 2;
+
+	// Only used to sleep while there is nothing new to take
+	std::mutex waitMutex;
+	std::condition_variable waitCondition;
+
+public:
+	// Producer side
+	T& GetBack() {
+		return buffers[backIndex];
+	}
+
+	void Publish() {
+		backIndex = middle.exchange(backIndex | NEW_BIT) & ~NEW_BIT;
+		std::lock_guard<std::mutex> lock(waitMutex);
+		waitCondition.notify_one();
+	}
+
+	// Consumer side, returns true if a newer value is now in the front buffer
+	bool Acquire() {
+		if (!(middle.load() & NEW_BIT)) {
+			return false;
+		}
+		frontIndex = middle.exchange(frontIndex) & ~NEW_BIT;
+		return true;
+	}
+
+	const T& GetFront() const {
+		return buffers[frontIndex];
+	}
+
+	// Sleep until something new is published or the timeout expires
+	bool WaitForPublish(std::chrono::microseconds timeout) {
+		std::unique_lock<std::mutex> lock(waitMutex);
+		return waitCondition.wait_for(lock, timeout, [this]() { return (middle.load() & NEW_BIT) != 0; });
+	}
+};
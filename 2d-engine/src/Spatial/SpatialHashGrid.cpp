@@ -0,0 +1,126 @@
+#include "SpatialHashGrid.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialHashGrid::SpatialHashGrid(float cellSize) {
+	this->cellSize = cellSize;
+}
+
+uint64_t SpatialHashGrid::GetCellKey(int cellX, int cellY) {
+	// Both signed coordinates packed in 64 bits, negative cells are valid too
+	return (static_cast<uint64_t>(static_cast<uint32_t>(cellX)) << 32) | static_cast<uint32_t>(cellY);
+}
+
+SpatialHashGrid::CellRange SpatialHashGrid::GetCellRange(const SDL_FRect& area) const {
+	CellRange range;
+	range.minX = static_cast<int>(std::floor(area.x / cellSize));
+	range.minY = static_cast<int>(std::floor(area.y / cellSize));
+	range.maxX = static_cast<int>(std::floor((area.x + area.w) / cellSize));
+	range.maxY = static_cast<int>(std::floor((area.y + area.h) / cellSize));
+	return range;
+}
+
+void SpatialHashGrid::AddToCells(int entityId, const CellRange& range) {
+	for (int y = range.minY; y <= range.maxY; y++) {
+		for (int x = range.minX; x <= range.maxX; x++) {
+			cells[GetCellKey(x, y)].push_back(entityId);
+		}
+	}
+}
+
+void SpatialHashGrid::RemoveFromCells(int entityId, const CellRange& range) {
+	for (int y = range.minY; y <= range.maxY; y++) {
+		for (int x = range.minX; x <= range.maxX; x++) {
+			auto cell = cells.find(GetCellKey(x, y));
+			if (cell == cells.end()) {
+				continue;
+			}
+			// The order inside a cell does not matter, swap with the last one and pop
+			auto& ids = cell->second;
+			auto id = std::find(ids.begin(), ids.end(), entityId);
+			if (id != ids.end()) {
+				*id = ids.back();
+				ids.pop_back();
+			}
+			if (ids.empty()) {
+				cells.erase(cell);
+			}
+		}
+	}
+}
+
+void SpatialHashGrid::Insert(int entityId, const SDL_FRect& bounds) {
+	if (entityId >= static_cast<int>(entries.size())) {
+		entries.resize(entityId + 1);
+	}
+	auto& entry = entries[entityId];
+	if (entry.isInGrid) {
+		Update(entityId, bounds);
+		return;
+	}
+	entry.bounds = bounds;
+	entry.cells = GetCellRange(bounds);
+	entry.isInGrid = true;
+	AddToCells(entityId, entry.cells);
+}
+
+void SpatialHashGrid::Remove(int entityId) {
+	if (!Contains(entityId)) {
+		return;
+	}
+	auto& entry = entries[entityId];
+	RemoveFromCells(entityId, entry.cells);
+	entry.isInGrid = false;
+}
+
+void SpatialHashGrid::Update(int entityId, const SDL_FRect& bounds) {
+	if (!Contains(entityId)) {
+		Insert(entityId, bounds);
+		return;
+	}
+	auto& entry = entries[entityId];
+	entry.bounds = bounds;
+
+	const CellRange range = GetCellRange(bounds);
+	if (range == entry.cells) {
+		return;
+	}
+	RemoveFromCells(entityId, entry.cells);
+	AddToCells(entityId, range);
+	entry.cells = range;
+}
+
+bool SpatialHashGrid::Contains(int entityId) const {
+	return entityId < static_cast<int>(entries.size()) && entries[entityId].isInGrid;
+}
+
+void SpatialHashGrid::Query(const SDL_FRect& area, std::vector<int>& result) {
+	currentQueryStamp++;
+	const CellRange range = GetCellRange(area);
+	for (int y = range.minY; y <= range.maxY; y++) {
+		for (int x = range.minX; x <= range.maxX; x++) {
+			auto cell = cells.find(GetCellKey(x, y));
+			if (cell == cells.end()) {
+				continue;
+			}
+			for (int entityId : cell->second) {
+				auto& entry = entries[entityId];
+				if (entry.queryStamp == currentQueryStamp) {
+					continue;
+				}
+				entry.queryStamp = currentQueryStamp;
+
+				// Sharing a cell is not enough, the bounds must really overlap the area
+				const auto& bounds = entry.bounds;
+				if (bounds.x < area.x + area.w && bounds.x + bounds.w > area.x &&
+					bounds.y < area.y + area.h && bounds.y + bounds.h > area.y) {
+					result.push_back(entityId);
+				}
+			}
+		}
+	}
+}
+
+size_t SpatialHashGrid::GetNumCells() const {
+	return cells.size();
+}
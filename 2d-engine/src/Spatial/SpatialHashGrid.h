@@ -0,0 +1,62 @@
+#pragma once
+#include <SDL.h>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/////////////////////////////////////////////////////////////////////////////////
+// SpatialHashGrid
+/////////////////////////////////////////////////////////////////////////////////
+// Spatial index of entity bounds over an unbounded grid of square cells. Each
+// entity is registered in every cell its bounds overlap, so an area query only
+// visits the cells of that area, no matter how big the world is.
+/////////////////////////////////////////////////////////////////////////////////
+class SpatialHashGrid {
+private:
+	struct CellRange {
+		int minX;
+		int minY;
+		int maxX;
+		int maxY;
+
+		bool operator ==(const CellRange& other) const {
+			return minX == other.minX && minY == other.minY && maxX == other.maxX && maxY == other.maxY;
+		}
+	};
+
+	struct Entry {
+		SDL_FRect bounds;
+		CellRange cells;
+		bool isInGrid = false;
+		// Last query that returned this entity, avoids duplicates when it spans several cells
+		unsigned int queryStamp = 0;
+	};
+
+	float cellSize;
+	std::unordered_map<uint64_t, std::vector<int>> cells;
+
+	// [index = entity id]
+	std::vector<Entry> entries;
+	unsigned int currentQueryStamp = 0;
+
+	static uint64_t GetCellKey(int cellX, int cellY);
+	CellRange GetCellRange(const SDL_FRect& area) const;
+	void AddToCells(int entityId, const CellRange& range);
+	void RemoveFromCells(int entityId, const CellRange& range);
+
+public:
+	SpatialHashGrid(float cellSize = 256.0f);
+
+	void Insert(int entityId, const SDL_FRect& bounds);
+	void Remove(int entityId);
+
+	// Cells are only touched when the entity moves to a different set of cells
+	void Update(int entityId, const SDL_FRect& bounds);
+
+	bool Contains(int entityId) const;
+
+	// Append to the result the ids of the entities whose bounds overlap the area, without duplicates
+	void Query(const SDL_FRect& area, std::vector<int>& result);
+
+	size_t GetNumCells() const;
+};
@@ -2,6 +2,7 @@
 
 #include <SDL.h>
 #include "../ECS/ECS.h"
+#include "../Profiler/Profiler.h"
 #include "../Components/SpriteComponent.h"
 #include "../Components/AnimationComponent.h"
 
@@ -13,6 +14,7 @@ public:
     }
 
     void Update() {
+        PROFILE_SCOPE("AnimationSystem::Update");
         for (auto entity : GetSystemEntities()) {
             auto& animation = entity.GetComponent<AnimationComponent>();
             auto& sprite = entity.GetComponent<SpriteComponent>();
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "../ECS/ECS.h"
+#include "../Profiler/Profiler.h"
+#include "../Components/CameraComponent.h"
+#include "../Components/TransformComponent.h"
+#include "../Camera/Camera.h"
+
+class CameraMovementSystem: public System {
+public:
+    CameraMovementSystem() {
+        RequireComponent<CameraComponent>();
+        RequireComponent<TransformComponent>();
+    }
+
+    void Update(Camera& camera) {
+        PROFILE_SCOPE("CameraMovementSystem::Update");
+        // The camera is centered on the followed entity, and clamped to the limits of the world
+        for (auto entity : GetSystemEntities()) {
+            const auto& transform = entity.GetComponent<TransformComponent>();
+            const auto& cameraComponent = entity.GetComponent<CameraComponent>();
+            camera.CenterOn(transform.position + cameraComponent.offset);
+        }
+    }
+};
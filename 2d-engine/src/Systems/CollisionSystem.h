@@ -1,61 +1,169 @@
 #pragma once
 
 #include "../ECS/ECS.h"
+#include "../Profiler/Profiler.h"
 #include "../Components/BoxColliderComponent.h"
 #include "../Components/TransformComponent.h"
 #include "../EventBus/EventBus.h" 
-#include "../events/CollisionEvent.h" 
-#include <spdlog/spdlog.h>
+#include "../Events/CollisionEvent.h" 
+#include "../Threading/ThreadPool.h"
+#include <vector>
 
 class CollisionSystem: public System {
+private:
+    // World space box of every collider, gathered once per frame
+    struct ColliderBox {
+        Entity entity;
+        int x;
+        int y;
+        int width;
+        int height;
+    };
+
+    struct CollisionPair {
+        Entity a;
+        Entity b;
+    };
+
+    std::vector<ColliderBox> colliders;
+    std::vector<CollisionPair> collisions;
+    size_t numCandidatePairs = 0;
+    size_t numCollisions = 0;
+
+    // Optional, with enough colliders the narrowphase runs on its threads
+    ThreadPool* threadPool = nullptr;
+    // First row of every block of the parallel narrowphase and the collisions each block found
+    std::vector<size_t> blockStarts;
+    std::vector<size_t> blockCollisions;
+
 public:
+    // Below this number of colliders the narrowphase is not worth splitting
+    static constexpr size_t MIN_PARALLEL_COLLIDERS = 512;
+    // Blocks of the parallel narrowphase, each one emits into its own event lane
+    static constexpr int NUM_NARROWPHASE_BLOCKS = 64;
+
     CollisionSystem() {
         RequireComponent<TransformComponent>();
         RequireComponent<BoxColliderComponent>();
     }
 
     void Update(std::unique_ptr<EventBus>& eventBus) {
-        auto entities = GetSystemEntities();
+        PROFILE_SCOPE("CollisionSystem::Update");
+        UpdateBroadphase();
+        if (threadPool && colliders.size() >= MIN_PARALLEL_COLLIDERS && eventBus->IsQueued<CollisionEvent>()) {
+            UpdateNarrowphaseParallel(*eventBus);
+            return;
+        }
+        UpdateNarrowphase();
+        DispatchCollisionEvents(eventBus);
+    }
 
-        // Loop all the entities that the system is interested in
-        for (auto i = entities.begin(); i != entities.end(); i++) {
-            Entity a = *i;
-            const auto& aTransform = a.GetComponent<TransformComponent>();
-            const auto& aCollider = a.GetComponent<BoxColliderComponent>();
+    void SetThreadPool(ThreadPool* threadPool) {
+        this->threadPool = threadPool;
+    }
 
-            // Loop all the entities that still need to be checked (to the right of i)
-            for (auto j = i; j != entities.end(); j++) {
-                Entity b = *j;
+    // Broadphase: gather the boxes of all the entities that the system is interested in
+    // Every pair of boxes is a candidate pair, so there is nothing more to prune here yet
+    void UpdateBroadphase() {
+        PROFILE_SCOPE("CollisionSystem::UpdateBroadphase");
+        colliders.clear();
+        for (auto entity : GetSystemEntities()) {
+            const auto& transform = entity.GetComponent<TransformComponent>();
+            const auto& collider = entity.GetComponent<BoxColliderComponent>();
+            colliders.push_back({
+                entity,
+                static_cast<int>(transform.position.x + collider.offset.x),
+                static_cast<int>(transform.position.y + collider.offset.y),
+                collider.width,
+                collider.height
+            });
+        }
+        const size_t n = colliders.size();
+        numCandidatePairs = n > 1 ? n * (n - 1) / 2 : 0;
+    }
+
+    // Narrowphase: perform the AABB collision check between the candidate pairs
+    void UpdateNarrowphase() {
+        PROFILE_SCOPE("CollisionSystem::UpdateNarrowphase");
+        collisions.clear();
+        for (size_t i = 0; i < colliders.size(); i++) {
+            const auto& a = colliders[i];
 
-                // Bypass if we are trying to test the same entity
-                if (a == b) {
-                    continue;
+            // Loop all the entities that still need to be checked (to the right of i)
+            for (size_t j = i + 1; j < colliders.size(); j++) {
+                const auto& b = colliders[j];
+                if (CheckAABBCollision(a.x, a.y, a.width, a.height, b.x, b.y, b.width, b.height)) {
+                    collisions.push_back({ a.entity, b.entity });
                 }
+            }
+        }
+        numCollisions = collisions.size();
+    }
+
+    // Narrowphase split in blocks of rows with about the same number of pairs
+    // The workers emit the collision events straight into the lane of their
+    // block, the lanes are dispatched in order so the events arrive in the
+    // same order as with the serial narrowphase
+    void UpdateNarrowphaseParallel(EventBus& eventBus) {
+        PROFILE_SCOPE("CollisionSystem::UpdateNarrowphaseParallel");
+        collisions.clear();
+        const size_t n = colliders.size();
+
+        blockStarts.assign(NUM_NARROWPHASE_BLOCKS + 1, n);
+        blockStarts[0] = 0;
+        size_t numPairs = 0;
+        int block = 1;
+        for (size_t i = 0; i < n && block < NUM_NARROWPHASE_BLOCKS; i++) {
+            numPairs += n - i - 1;
+            while (block < NUM_NARROWPHASE_BLOCKS && numPairs * NUM_NARROWPHASE_BLOCKS >= numCandidatePairs * block) {
+                blockStarts[block++] = i + 1;
+            }
+        }
 
-                const auto& bTransform = b.GetComponent<TransformComponent>();
-                const auto& bCollider = b.GetComponent<BoxColliderComponent>();
-                 
-                // Perform the AABB collision check between entities a and b
-                bool collisionHappened = CheckAABBCollision(
-                    aTransform.position.x + aCollider.offset.x,
-                    aTransform.position.y + aCollider.offset.y,
-                    aCollider.width,
-                    aCollider.height,
-                    bTransform.position.x + bCollider.offset.x,
-                    bTransform.position.y + bCollider.offset.y,
-                    bCollider.width,
-                    bCollider.height
-                ); 
-
-                if (collisionHappened) {
-                    spdlog::info("EntityId = {} is colliding with entity {}", a.GetId(), b.GetId());
-                    eventBus->EmitEvent<CollisionEvent>(a, b);
+        blockCollisions.assign(NUM_NARROWPHASE_BLOCKS, 0);
+        eventBus.ReserveEventLanes(NUM_NARROWPHASE_BLOCKS);
+        threadPool->ParallelFor(NUM_NARROWPHASE_BLOCKS, [&](int block) {
+            size_t numBlockCollisions = 0;
+            for (size_t i = blockStarts[block]; i < blockStarts[block + 1]; i++) {
+                const auto& a = colliders[i];
+                for (size_t j = i + 1; j < n; j++) {
+                    const auto& b = colliders[j];
+                    if (CheckAABBCollision(a.x, a.y, a.width, a.height, b.x, b.y, b.width, b.height)) {
+                        eventBus.EmitEventToLane<CollisionEvent>(block, a.entity, b.entity);
+                        numBlockCollisions++;
+                    }
                 }
             }
+            blockCollisions[block] = numBlockCollisions;
+        });
+
+        numCollisions = 0;
+        for (size_t numBlockCollisions : blockCollisions) {
+            numCollisions += numBlockCollisions;
         }
     }
 
-    bool CheckAABBCollision(int aX, int aY, int aW, int aH, int bX, int bY, int bW, int bH) {
+    // Emit a collision event for every pair found by the narrowphase
+    void DispatchCollisionEvents(std::unique_ptr<EventBus>& eventBus) {
+        PROFILE_SCOPE("CollisionSystem::DispatchCollisionEvents");
+        for (auto& collision : collisions) {
+            eventBus->EmitEvent<CollisionEvent>(collision.a, collision.b);
+        }
+    }
+
+    size_t GetNumColliders() const {
+        return colliders.size();
+    }
+
+    size_t GetNumCandidatePairs() const {
+        return numCandidatePairs;
+    }
+
+    size_t GetNumCollisions() const {
+        return numCollisions;
+    }
+
+    bool CheckAABBCollision(int aX, int aY, int aW, int aH, int bX, int bY, int bW, int bH) const {
         return (
             aX < bX + bW &&
             aX + aW > bX &&
@@ -63,4 +171,4 @@ public:
             aY + aH > bY
         );
     }
-};
\ No newline at end of file
+};
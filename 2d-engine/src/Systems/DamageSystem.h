@@ -7,13 +7,27 @@
 #include <spdlog/spdlog.h>
 
 class DamageSystem: public System {
+    private:
+        ScopedSubscription collisionSubscription;
+
     public:
         DamageSystem() {
             RequireComponent<BoxColliderComponent>();
         }
 
+        // Subscribing again replaces the previous subscription
         void SubscribeToEvents(std::unique_ptr<EventBus>& eventBus) {
-            eventBus->SubscribeToEvent<CollisionEvent>(this, &DamageSystem::onCollision);
+            collisionSubscription = ScopedSubscription(*eventBus, eventBus->SubscribeToEventBatch<CollisionEvent>(this, &DamageSystem::onCollisions));
+        }
+
+        // All the collisions of the step at once when the collision events are queued
+        // The ones a handler of higher priority consumed, e.g. a shield, do no damage
+        void onCollisions(EventSpan<CollisionEvent> events) {
+            for (auto& event : events) {
+                if (!event.IsConsumed()) {
+                    onCollision(event);
+                }
+            }
         }
 
         void onCollision(CollisionEvent& event) {
@@ -8,13 +8,17 @@
 #include <spdlog/spdlog.h>
 
 class KeyboardControlSystem: public System {
+    private:
+        ScopedSubscription keyPressedSubscription;
+
     public:
         KeyboardControlSystem() {
         
         }
 
+        // Subscribing again replaces the previous subscription
         void SubscribeToEvents(std::unique_ptr<EventBus>& eventBus) {
-            eventBus->SubscribeToEvent<KeyPressedEvent>(this, &KeyboardControlSystem::OnKeyPressed);
+            keyPressedSubscription = ScopedSubscription(*eventBus, eventBus->SubscribeToEvent<KeyPressedEvent>(this, &KeyboardControlSystem::OnKeyPressed));
         }
 
         void OnKeyPressed(KeyPressedEvent& event) {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../ECS/ECS.h"
+#include "../Profiler/Profiler.h"
 #include "../Components/TransformComponent.h"
 #include "../Components/RigidBodyComponent.h"
 #include <spdlog/spdlog.h>
@@ -13,12 +14,17 @@ public:
 	}
 
 	void Update(double deltaTime) {
+		PROFILE_SCOPE("MovementSystem::Update");
 		// Loop all entities that the system is interested in
 		for (auto entity : GetSystemEntities()) {
 			// Update entity position based on its velocity every frame of the game loop.
 			auto& transform = entity.GetComponent<TransformComponent>();
 			const auto rigidbody = entity.GetComponent<RigidBodyComponent>();
 
+			// Keep where the step started, later systems of the same step like the collisions still move it
+			transform.previousPosition = transform.position;
+			transform.previousRotation = transform.rotation;
+
 			transform.position.x += rigidbody.velocity.x * static_cast<float>(deltaTime);
 			transform.position.y += rigidbody.velocity.y * static_cast<float>(deltaTime);
 
@@ -1,8 +1,10 @@
 #pragma once
 
 #include "../ECS/ECS.h"
+#include "../Profiler/Profiler.h"
 #include "../Components/TransformComponent.h"
 #include "../Components/BoxColliderComponent.h"
+#include "../Renderer/RenderSnapshot.h"
 #include <SDL.h>
 
 class RenderColliderSystem: public System {
@@ -12,19 +14,19 @@ public:
         RequireComponent<BoxColliderComponent>();
     }
 
-    void Update(SDL_Renderer* renderer) {
+    // In world coordinates, the render thread moves them with the interpolated camera
+    void BuildSnapshot(RenderSnapshot& snapshot) {
+        PROFILE_SCOPE("RenderColliderSystem::BuildSnapshot");
         for (auto entity: GetSystemEntities()) {
             const auto& transform = entity.GetComponent<TransformComponent>();
             const auto& collider = entity.GetComponent<BoxColliderComponent>();
 
-            SDL_Rect colliderRect = {
-                static_cast<int>(transform.position.x + collider.offset.x),
-                static_cast<int>(transform.position.y + collider.offset.y),
-                static_cast<int>(collider.width),
-                static_cast<int>(collider.height)
-            };
-            SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-            SDL_RenderDrawRect(renderer, &colliderRect);
+            snapshot.colliders.push_back({
+                transform.position + collider.offset,
+                transform.previousPosition + collider.offset,
+                static_cast<float>(collider.width),
+                static_cast<float>(collider.height)
+            });
         }
     }
 };
@@ -1,65 +1,142 @@
 #pragma once
 #include "../ECS/ECS.h"
+#include "../Profiler/Profiler.h"
 #include "../Components/TransformComponent.h"
 #include "../Components/SpriteComponent.h"
+#include "../Components/RigidBodyComponent.h"
+#include "../AssetStore/AssetStore.h"
+#include "../Camera/Camera.h"
+#include "../Renderer/RenderList.h"
+#include "../Renderer/RenderSnapshot.h"
 #include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
 class RenderSystem : public System {
+private:
+    // Entities sorted by z-index and indexed by position, kept between frames instead of being rebuilt every frame
+    RenderList renderList;
+
+    // Entities with a rigid body can move, their bounds are refreshed every frame
+    // The bounds of all the others are indexed once when they are added
+    std::vector<Entity> movingEntities;
+
+    // Ids of the entities whose z-index changed through SpriteComponent::SetZIndex, visible or not
+    std::vector<int> zIndexChanges;
+    Registry* registry = nullptr;
+
+    int numVisibleSprites = 0;
+
+    static SDL_FRect GetSpriteBounds(const TransformComponent& transform, const SpriteComponent& sprite) {
+        SDL_FRect bounds = {
+            transform.position.x,
+            transform.position.y,
+            sprite.width * transform.scale.x,
+            sprite.height * transform.scale.y
+        };
+        // A rotated sprite can reach as far as the circle around it
+        if (transform.rotation != 0.0) {
+            const float diagonal = std::sqrt(bounds.w * bounds.w + bounds.h * bounds.h);
+            bounds.x -= (diagonal - bounds.w) * 0.5f;
+            bounds.y -= (diagonal - bounds.h) * 0.5f;
+            bounds.w = diagonal;
+            bounds.h = diagonal;
+        }
+        return bounds;
+    }
+
+protected:
+    void OnEntityAdded(Entity entity) override {
+        const auto& transform = entity.GetComponent<TransformComponent>();
+        auto& sprite = entity.GetComponent<SpriteComponent>();
+        sprite.zIndexChanges = &zIndexChanges;
+        sprite.entityId = entity.GetId();
+        registry = entity.registry;
+        renderList.Insert(entity, sprite.zIndex, GetSpriteBounds(transform, sprite), sprite.isFixed);
+        if (entity.HasComponent<RigidBodyComponent>()) {
+            movingEntities.push_back(entity);
+        }
+    }
+
+    void OnEntityRemoved(Entity entity) override {
+        renderList.Remove(entity);
+        movingEntities.erase(std::remove(movingEntities.begin(), movingEntities.end(), entity), movingEntities.end());
+    }
+
 public:
     RenderSystem() {
         RequireComponent<TransformComponent>();
         RequireComponent<SpriteComponent>();
     }
 
-    void Update(SDL_Renderer* renderer, std::unique_ptr<AssetStore>& assetStore) {
-
-        // Create a vector with both Sprite and Transform component of all entities
-        struct RenderableEntity {
-            TransformComponent transformComponent;
-            SpriteComponent spriteComponent;
-        };
-
-        std::vector<RenderableEntity> renderableEntities;
+    // Copy the visible sprites into the snapshot, the render thread draws them while the simulation goes on
+    void BuildSnapshot(const AssetStore& assetStore, const Camera& camera, RenderSnapshot& snapshot) {
+        PROFILE_SCOPE("RenderSystem::BuildSnapshot");
+        // Only the entities that changed their z-index, an entity that changed it off screen
+        // is already in its new bucket when it shows up. The id may belong to a removed entity
+        for (int entityId : zIndexChanges) {
+            Entity entity(entityId);
+            entity.registry = registry;
+            if (renderList.Contains(entity)) {
+                renderList.Rebucket(entity, entity.GetComponent<SpriteComponent>().zIndex);
+            }
+        }
+        zIndexChanges.clear();
 
-        for (auto entity : GetSystemEntities()) {
-            RenderableEntity renderableEntity;
-            renderableEntity.spriteComponent = entity.GetComponent<SpriteComponent>();
-            renderableEntity.transformComponent = entity.GetComponent<TransformComponent>();
-            renderableEntities.emplace_back(renderableEntity);
+        for (auto entity : movingEntities) {
+            const auto& transform = entity.GetComponent<TransformComponent>();
+            const auto& sprite = entity.GetComponent<SpriteComponent>();
+            renderList.UpdateBounds(entity, GetSpriteBounds(transform, sprite));
         }
 
-        // Sort the vector by z-index value
-        std::sort(renderableEntities.begin(), renderableEntities.end(), [](const RenderableEntity& a, const RenderableEntity& b) {
-            return a.spriteComponent.zIndex < b.spriteComponent.zIndex;
-        });
+        numVisibleSprites = 0;
+        const size_t firstSprite = snapshot.sprites.size();
 
-        // Loop all entities that the system is interested in
-        for (auto entity : renderableEntities) {
-            const auto transform = entity.transformComponent;
-            const auto sprite = entity.spriteComponent;
+        // Loop back to front only the entities that are inside the camera view
+        const glm::vec2 cameraPosition = camera.GetPosition();
+        const glm::vec2 previousCameraPosition = snapshot.previousCameraPosition;
+        renderList.ForEachVisible(camera.GetViewRect(), camera.GetScreenRect(), [&](Entity entity, int) {
+            const auto& transform = entity.GetComponent<TransformComponent>();
+            auto& sprite = entity.GetComponent<SpriteComponent>();
 
-            // Set the source rectangle of our original sprite texture
-            SDL_Rect srcRect = sprite.srcRect;
+            // Looked up by asset id once, not every frame, an unknown asset is looked up again until it is added
+            if (sprite.textureHandle == AssetStore::INVALID_TEXTURE_HANDLE) {
+                sprite.textureHandle = assetStore.GetTextureHandle(sprite.assetId);
+            }
 
-            // Set the destination rectangle with the x,y position to be rendered
-            SDL_Rect dstRect = {
-                static_cast<int>(transform.position.x),
-                static_cast<int>(transform.position.y),
-                static_cast<int>(sprite.width * transform.scale.x),
-                static_cast<int>(sprite.height * transform.scale.y)
+            // Set the destination rectangle with the x,y position to be rendered, relative to the camera
+            const glm::vec2 screenPosition = sprite.isFixed ? transform.position : transform.position - cameraPosition;
+            const glm::vec2 previousScreenPosition = sprite.isFixed ? transform.previousPosition : transform.previousPosition - previousCameraPosition;
+            SDL_FRect dstRect = {
+                screenPosition.x,
+                screenPosition.y,
+                sprite.width * transform.scale.x,
+                sprite.height * transform.scale.y
             };
 
-            // Render the texture on the destination renderer window
-            SDL_RenderCopyEx(
-                renderer,
-                assetStore->GetTexture(sprite.assetId),
-                &srcRect,
-                &dstRect,
-                transform.rotation,
-                NULL,
-                SDL_FLIP_NONE
-            );
-        }
+            snapshot.sprites.push_back({
+                sprite.textureHandle,
+                sprite.srcRect,
+                dstRect,
+                static_cast<float>(transform.rotation),
+                previousScreenPosition,
+                static_cast<float>(transform.previousRotation),
+                sprite.zIndex
+            });
+            numVisibleSprites++;
+        });
+
+        // By texture inside the same z-index so the batches are longer, stable to keep the order of the sprites of a texture
+        std::stable_sort(snapshot.sprites.begin() + firstSprite, snapshot.sprites.end(), [](const SpriteCommand& a, const SpriteCommand& b) {
+            if (a.zIndex != b.zIndex) {
+                return a.zIndex < b.zIndex;
+            }
+            return a.textureHandle < b.textureHandle;
+        });
+    }
+
+    int GetNumVisibleSprites() const {
+        return numVisibleSprites;
     }
-};
\ No newline at end of file
+};
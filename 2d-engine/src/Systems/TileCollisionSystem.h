@@ -0,0 +1,92 @@
+#pragma once
+
+#include "../ECS/ECS.h"
+#include "../Profiler/Profiler.h"
+#include "../Components/BoxColliderComponent.h"
+#include "../Components/TransformComponent.h"
+#include "../Components/RigidBodyComponent.h"
+#include "../EventBus/EventBus.h"
+#include "../Events/TileCollisionEvent.h"
+#include "../Components/TilemapComponent.h"
+#include "../Tilemap/TileCollisionLayer.h"
+#include <algorithm>
+#include <cmath>
+
+class TileCollisionSystem: public System {
+private:
+    // Solidity of the tilemap of the level, shared with its TilemapComponent
+    std::shared_ptr<TileCollisionLayer> tileCollisionLayer;
+
+public:
+    TileCollisionSystem() {
+        RequireComponent<TransformComponent>();
+        RequireComponent<BoxColliderComponent>();
+        RequireComponent<RigidBodyComponent>();
+    }
+
+    void SetTileCollisionLayer(std::shared_ptr<TileCollisionLayer> tileCollisionLayer) {
+        this->tileCollisionLayer = tileCollisionLayer;
+    }
+
+    void Update(std::unique_ptr<EventBus>& eventBus) {
+        PROFILE_SCOPE("TileCollisionSystem::Update");
+        if (!tileCollisionLayer) {
+            return;
+        }
+        const float tileSize = tileCollisionLayer->GetTileSize();
+
+        // Only the moving colliders are checked, the tiles never enter any loop
+        for (auto entity : GetSystemEntities()) {
+            auto& transform = entity.GetComponent<TransformComponent>();
+            auto& rigidbody = entity.GetComponent<RigidBodyComponent>();
+            const auto& collider = entity.GetComponent<BoxColliderComponent>();
+
+            const float boxX = transform.position.x + collider.offset.x;
+            const float boxY = transform.position.y + collider.offset.y;
+            const float boxW = static_cast<float>(collider.width);
+            const float boxH = static_cast<float>(collider.height);
+
+            glm::vec2 correction(0.0f);
+            int hitCol = -1;
+            int hitRow = -1;
+
+            tileCollisionLayer->ForEachSolidCell(boxX, boxY, boxW, boxH, [&](int col, int row) {
+                // Overlap against this cell after the corrections applied so far
+                const float x = boxX + correction.x;
+                const float y = boxY + correction.y;
+                const float cellX = col * tileSize;
+                const float cellY = row * tileSize;
+                const float overlapX = std::min(x + boxW, cellX + tileSize) - std::max(x, cellX);
+                const float overlapY = std::min(y + boxH, cellY + tileSize) - std::max(y, cellY);
+                if (overlapX <= 0 || overlapY <= 0) {
+                    return;
+                }
+
+                // Push the box out of the cell along the axis of minimum penetration
+                if (overlapX < overlapY) {
+                    correction.x += (x + boxW * 0.5f < cellX + tileSize * 0.5f) ? -overlapX : overlapX;
+                }
+                else {
+                    correction.y += (y + boxH * 0.5f < cellY + tileSize * 0.5f) ? -overlapY : overlapY;
+                }
+                hitCol = col;
+                hitRow = row;
+            });
+
+            if (hitCol < 0) {
+                continue;
+            }
+
+            // Stop the movement against the blocked axis
+            transform.position += correction;
+            if (correction.x != 0.0f) {
+                rigidbody.velocity.x = 0.0f;
+            }
+            if (correction.y != 0.0f) {
+                rigidbody.velocity.y = 0.0f;
+            }
+
+            eventBus->EmitEvent<TileCollisionEvent>(entity, hitCol, hitRow);
+        }
+    }
+};
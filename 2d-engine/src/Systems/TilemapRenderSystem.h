@@ -0,0 +1,24 @@
+#pragma once
+
+#include "../ECS/ECS.h"
+#include "../Profiler/Profiler.h"
+#include "../Components/TilemapComponent.h"
+#include "../Renderer/RenderSnapshot.h"
+
+class TilemapRenderSystem: public System {
+public:
+    TilemapRenderSystem() {
+        RequireComponent<TilemapComponent>();
+    }
+
+    // The snapshot keeps a copy of the tilemaps, it shares their chunks until the simulation changes them
+    void BuildSnapshot(RenderSnapshot& snapshot) {
+        PROFILE_SCOPE("TilemapRenderSystem::BuildSnapshot");
+        for (auto entity : GetSystemEntities()) {
+            const auto& tilemapComponent = entity.GetComponent<TilemapComponent>();
+            if (tilemapComponent.tilemap) {
+                snapshot.tilemaps.push_back(*tilemapComponent.tilemap);
+            }
+        }
+    }
+};
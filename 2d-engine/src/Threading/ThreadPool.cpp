@@ -0,0 +1,88 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+ThreadPool::ThreadPool(int numThreads) {
+	if (numThreads <= 0) {
+		numThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+	}
+	for (int i = 0; i < numThreads; i++) {
+		workers.emplace_back(&ThreadPool::WorkerLoop, this);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		isStopping = true;
+	}
+	condition.notify_all();
+	for (auto& worker : workers) {
+		worker.join();
+	}
+}
+
+void ThreadPool::WorkerLoop() {
+	while (true) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait(lock, [this]() { return isStopping || !tasks.empty(); });
+			if (isStopping && tasks.empty()) {
+				return;
+			}
+			task = std::move(tasks.front());
+			tasks.pop_front();
+		}
+		task();
+	}
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.push_back(std::move(task));
+	}
+	condition.notify_one();
+}
+
+void ThreadPool::ParallelFor(int count, const std::function<void(int index)>& function) {
+	if (count <= 0) {
+		return;
+	}
+
+	// Shared by the helpers, a helper can still be starting when the loop is already done
+	struct Range {
+		std::atomic<int> nextIndex { 0 };
+		std::atomic<int> numDone { 0 };
+		std::mutex mutex;
+		std::condition_variable done;
+	};
+	auto range = std::make_shared<Range>();
+
+	auto runIndices = [range, count, &function]() {
+		int index;
+		while ((index = range->nextIndex.fetch_add(1)) < count) {
+			function(index);
+			if (range->numDone.fetch_add(1) + 1 == count) {
+				std::lock_guard<std::mutex> lock(range->mutex);
+				range->done.notify_all();
+			}
+		}
+	};
+
+	const int numHelpers = std::min(count - 1, GetNumThreads());
+	for (int i = 0; i < numHelpers; i++) {
+		Submit(runIndices);
+	}
+	runIndices();
+
+	// The function is borrowed by the helpers, wait until every index has been run
+	std::unique_lock<std::mutex> lock(range->mutex);
+	range->done.wait(lock, [&range, count]() { return range->numDone.load() == count; });
+}
+
+int ThreadPool::GetNumThreads() const {
+	return static_cast<int>(workers.size());
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/////////////////////////////////////////////////////////////////////////////////
+// ThreadPool
+/////////////////////////////////////////////////////////////////////////////////
+// A fixed number of worker threads that run the tasks submitted to a queue.
+// ParallelFor splits a range of indices between the workers and the calling
+// thread, the indices are taken one by one so uneven tasks balance themselves.
+/////////////////////////////////////////////////////////////////////////////////
+class ThreadPool {
+private:
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::deque<std::function<void()>> tasks;
+	bool isStopping = false;
+
+	void WorkerLoop();
+
+public:
+	// 0 threads uses one per hardware thread
+	explicit ThreadPool(int numThreads = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator =(const ThreadPool&) = delete;
+
+	void Submit(std::function<void()> task);
+
+	// Runs function(index) for every index in [0, count) and returns when all of them are done
+	void ParallelFor(int count, const std::function<void(int index)>& function);
+
+	int GetNumThreads() const;
+};
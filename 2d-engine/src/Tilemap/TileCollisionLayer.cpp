@@ -0,0 +1,76 @@
+#include "TileCollisionLayer.h"
+#include <algorithm>
+#include <cmath>
+
+TileCollisionLayer::TileCollisionLayer(int numCols, int numRows, float tileSize) {
+	Resize(numCols, numRows, tileSize);
+}
+
+void TileCollisionLayer::Resize(int numCols, int numRows, float tileSize) {
+	this->numCols = numCols;
+	this->numRows = numRows;
+	this->tileSize = tileSize;
+	// 64 cells fit in every word of the bit grid
+	solidBits.assign((static_cast<size_t>(numCols) * numRows + 63) / 64, 0);
+}
+
+void TileCollisionLayer::Clear() {
+	std::fill(solidBits.begin(), solidBits.end(), 0);
+}
+
+void TileCollisionLayer::SetSolid(int col, int row, bool isSolid) {
+	if (col < 0 || row < 0 || col >= numCols || row >= numRows) {
+		return;
+	}
+	const size_t index = static_cast<size_t>(row) * numCols + col;
+	const uint64_t mask = uint64_t(1) << (index % 64);
+	if (isSolid) {
+		solidBits[index / 64] |= mask;
+	}
+	else {
+		solidBits[index / 64] &= ~mask;
+	}
+}
+
+bool TileCollisionLayer::IsSolid(int col, int row) const {
+	// Everything outside the map is walkable, leaving the map is not our business
+	if (col < 0 || row < 0 || col >= numCols || row >= numRows) {
+		return false;
+	}
+	const size_t index = static_cast<size_t>(row) * numCols + col;
+	return (solidBits[index / 64] >> (index % 64)) & 1;
+}
+
+int TileCollisionLayer::GetNumCols() const {
+	return numCols;
+}
+
+int TileCollisionLayer::GetNumRows() const {
+	return numRows;
+}
+
+float TileCollisionLayer::GetTileSize() const {
+	return tileSize;
+}
+
+bool TileCollisionLayer::GetOverlappedCells(float x, float y, float width, float height, int& firstCol, int& firstRow, int& lastCol, int& lastRow) const {
+	if (numCols == 0 || numRows == 0 || width <= 0 || height <= 0) {
+		return false;
+	}
+
+	// The right and bottom edges are exclusive, a box touching a cell does not overlap it
+	firstCol = static_cast<int>(std::floor(x / tileSize));
+	firstRow = static_cast<int>(std::floor(y / tileSize));
+	lastCol = static_cast<int>(std::ceil((x + width) / tileSize)) - 1;
+	lastRow = static_cast<int>(std::ceil((y + height) / tileSize)) - 1;
+
+	if (lastCol < 0 || lastRow < 0 || firstCol >= numCols || firstRow >= numRows) {
+		return false;
+	}
+
+	if (firstCol < 0) firstCol = 0;
+	if (firstRow < 0) firstRow = 0;
+	if (lastCol >= numCols) lastCol = numCols - 1;
+	if (lastRow >= numRows) lastRow = numRows - 1;
+	return true;
+}
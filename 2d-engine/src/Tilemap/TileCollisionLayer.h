@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+/////////////////////////////////////////////////////////////////////////////////
+// TileCollisionLayer
+/////////////////////////////////////////////////////////////////////////////////
+// Keeps the solidity of every tile of the map as a single bit, so the tiles 
+// themselves never become colliders. Movers are resolved against the layer by
+// looking up only the cells that their AABB overlaps.
+/////////////////////////////////////////////////////////////////////////////////
+class TileCollisionLayer {
+private:
+	int numCols;
+	int numRows;
+	float tileSize;
+
+	// One bit per cell, row major [index = row * numCols + col]
+	std::vector<uint64_t> solidBits;
+
+public:
+	TileCollisionLayer(int numCols = 0, int numRows = 0, float tileSize = 32.0f);
+
+	void Resize(int numCols, int numRows, float tileSize);
+	void Clear();
+
+	void SetSolid(int col, int row, bool isSolid = true);
+	bool IsSolid(int col, int row) const;
+
+	int GetNumCols() const;
+	int GetNumRows() const;
+	float GetTileSize() const;
+
+	// Range of cells [firstCol..lastCol] x [firstRow..lastRow] overlapped by an area,
+	// clamped to the map. Returns false if the area lies completely outside the map
+	bool GetOverlappedCells(float x, float y, float width, float height, int& firstCol, int& firstRow, int& lastCol, int& lastRow) const;
+
+	// Visit every solid cell overlapped by an area, the cost is O(cells overlapped)
+	template <typename TFunction>
+	void ForEachSolidCell(float x, float y, float width, float height, TFunction function) const;
+};
+
+template <typename TFunction>
+void TileCollisionLayer::ForEachSolidCell(float x, float y, float width, float height, TFunction function) const {
+	int firstCol, firstRow, lastCol, lastRow;
+	if (!GetOverlappedCells(x, y, width, height, firstCol, firstRow, lastCol, lastRow)) {
+		return;
+	}
+	for (int row = firstRow; row <= lastRow; row++) {
+		for (int col = firstCol; col <= lastCol; col++) {
+			if (IsSolid(col, row)) {
+				function(col, row);
+			}
+		}
+	}
+}
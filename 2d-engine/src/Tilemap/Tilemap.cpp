@@ -0,0 +1,93 @@
+#include "Tilemap.h"
+#include <atomic>
+
+void Tilemap::Resize(int numCols, int numRows, int tileSize, double tileScale, const std::string& tilesetAssetId) {
+	static std::atomic<unsigned int> nextId(1);
+	id = nextId++;
+	this->numCols = numCols;
+	this->numRows = numRows;
+	this->tileSize = tileSize;
+	this->tileScale = tileScale;
+	this->tilesetAssetId = tilesetAssetId;
+	// The previous chunks are left to the copies that still use them
+	chunks = std::make_shared<ChunkTable>(static_cast<size_t>(GetNumChunkCols()) * GetNumChunkRows());
+	for (auto& chunk : *chunks) {
+		chunk = std::make_shared<Chunk>();
+		chunk->tiles.assign(CHUNK_SIZE * CHUNK_SIZE, 0);
+	}
+}
+
+unsigned int Tilemap::GetId() const {
+	return id;
+}
+
+uint16_t Tilemap::GetTile(int col, int row) const {
+	if (col < 0 || row < 0 || col >= numCols || row >= numRows) {
+		return 0;
+	}
+	const auto& chunk = (*chunks)[static_cast<size_t>(row / CHUNK_SIZE) * GetNumChunkCols() + col / CHUNK_SIZE];
+	return chunk->tiles[(row % CHUNK_SIZE) * CHUNK_SIZE + col % CHUNK_SIZE];
+}
+
+void Tilemap::SetTile(int col, int row, uint16_t tileId) {
+	if (col < 0 || row < 0 || col >= numCols || row >= numRows || GetTile(col, row) == tileId) {
+		return;
+	}
+	auto& chunk = GetWritableChunk(col / CHUNK_SIZE, row / CHUNK_SIZE);
+	chunk.tiles[(row % CHUNK_SIZE) * CHUNK_SIZE + col % CHUNK_SIZE] = tileId;
+	chunk.revision++;
+}
+
+Tilemap::Chunk& Tilemap::GetWritableChunk(int chunkCol, int chunkRow) {
+	// Only this map can add owners to its table and chunks, the other threads can only drop theirs,
+	// so a single owner means nobody else reads them
+	if (chunks.use_count() > 1) {
+		chunks = std::make_shared<ChunkTable>(*chunks);
+	}
+	auto& chunk = (*chunks)[static_cast<size_t>(chunkRow) * GetNumChunkCols() + chunkCol];
+	if (chunk.use_count() > 1) {
+		chunk = std::make_shared<Chunk>(*chunk);
+	}
+	return *chunk;
+}
+
+SDL_Rect Tilemap::GetTileSrcRect(uint16_t tileId) const {
+	return {
+		(tileId % TILESET_ID_BASE) * tileSize,
+		(tileId / TILESET_ID_BASE) * tileSize,
+		tileSize,
+		tileSize
+	};
+}
+
+int Tilemap::GetNumCols() const {
+	return numCols;
+}
+
+int Tilemap::GetNumRows() const {
+	return numRows;
+}
+
+int Tilemap::GetTileSize() const {
+	return tileSize;
+}
+
+double Tilemap::GetTileScale() const {
+	return tileScale;
+}
+
+const std::string& Tilemap::GetTilesetAssetId() const {
+	return tilesetAssetId;
+}
+
+int Tilemap::GetNumChunkCols() const {
+	return (numCols + CHUNK_SIZE - 1) / CHUNK_SIZE;
+}
+
+int Tilemap::GetNumChunkRows() const {
+	return (numRows + CHUNK_SIZE - 1) / CHUNK_SIZE;
+}
+
+unsigned int Tilemap::GetChunkRevision(int chunkCol, int chunkRow) const {
+	return (*chunks)[static_cast<size_t>(chunkRow) * GetNumChunkCols() + chunkCol]->revision;
+}
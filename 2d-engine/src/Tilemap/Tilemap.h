@@ -0,0 +1,68 @@
+#pragma once
+#include <SDL.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/////////////////////////////////////////////////////////////////////////////////
+// Tilemap
+/////////////////////////////////////////////////////////////////////////////////
+// Tile ids of a map, one per cell. A tile id is the row of the tile in the 
+// tileset * 10 + its column, the same two digits used by the .map files.
+// The map is split in square chunks of tiles, every chunk keeps a revision 
+// number that increases when any of its tiles changes.
+// Copying a map is cheap, the copies share their chunks and a chunk is copied
+// only when one of them changes it. The render snapshots keep a copy, so the
+// simulation can change the tiles while the render thread bakes the chunks.
+/////////////////////////////////////////////////////////////////////////////////
+class Tilemap {
+private:
+	int numCols = 0;
+	int numRows = 0;
+	int tileSize = 32;
+	double tileScale = 1.0;
+	std::string tilesetAssetId;
+
+	struct Chunk {
+		// Row major [index = row * CHUNK_SIZE + col], the border chunks keep the full size
+		std::vector<uint16_t> tiles;
+		unsigned int revision = 0;
+	};
+	using ChunkTable = std::vector<std::shared_ptr<Chunk>>;
+
+	// Shared with the copies of the map, they are never changed while shared
+	std::shared_ptr<ChunkTable> chunks;
+	unsigned int id = 0;
+
+	// Returns the chunk ready to be changed, copying it first if it is shared
+	Chunk& GetWritableChunk(int chunkCol, int chunkRow);
+
+public:
+	// Width and height of a chunk, in tiles
+	static constexpr int CHUNK_SIZE = 16;
+	static constexpr int TILESET_ID_BASE = 10;
+
+	Tilemap() = default;
+
+	// Identifies the map and its copies, a new id is given when the map is resized
+	unsigned int GetId() const;
+
+	void Resize(int numCols, int numRows, int tileSize, double tileScale, const std::string& tilesetAssetId);
+
+	uint16_t GetTile(int col, int row) const;
+	void SetTile(int col, int row, uint16_t tileId);
+
+	// Source rectangle of a tile id inside the tileset image
+	SDL_Rect GetTileSrcRect(uint16_t tileId) const;
+
+	int GetNumCols() const;
+	int GetNumRows() const;
+	int GetTileSize() const;
+	double GetTileScale() const;
+	const std::string& GetTilesetAssetId() const;
+
+	int GetNumChunkCols() const;
+	int GetNumChunkRows() const;
+	unsigned int GetChunkRevision(int chunkCol, int chunkRow) const;
+};
@@ -0,0 +1,185 @@
+#include "TilemapLoader.h"
+#include <cstring>
+#include <fstream>
+#include <spdlog/spdlog.h>
+
+constexpr char TilemapLoader::BINARY_MAGIC[4];
+constexpr uint32_t TilemapLoader::BINARY_VERSION;
+constexpr uint32_t TilemapLoader::MAX_SIZE;
+
+// Size of the binary header: magic, version, columns and rows
+const size_t BINARY_HEADER_SIZE = 16;
+
+static bool EndsWith(const std::string& text, const std::string& suffix) {
+	return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+static uint32_t ReadUint32(const char* data) {
+	const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+	return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+static void WriteUint32(std::vector<char>& buffer, uint32_t value) {
+	for (int i = 0; i < 4; i++) {
+		buffer.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+	}
+}
+
+bool TilemapLoader::ReadFile(const std::string& filePath, std::vector<char>& buffer) {
+	std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+	if (!file) {
+		return false;
+	}
+	const std::streamsize size = file.tellg();
+	file.seekg(0, std::ios::beg);
+	buffer.resize(static_cast<size_t>(size));
+	return static_cast<bool>(file.read(buffer.data(), size));
+}
+
+bool TilemapLoader::ParseText(const std::vector<char>& buffer, std::vector<uint16_t>& tiles, int& numCols, int& numRows) {
+	tiles.clear();
+	numCols = 0;
+	numRows = 0;
+
+	int colsInRow = 0;
+	int value = 0;
+	bool hasDigits = false;
+
+	// A tile ends at a comma or at the end of a line, a row ends at the end of a line
+	auto endTile = [&]() {
+		if (hasDigits) {
+			tiles.push_back(static_cast<uint16_t>(value));
+			colsInRow++;
+		}
+		value = 0;
+		hasDigits = false;
+	};
+	auto endRow = [&]() {
+		endTile();
+		if (colsInRow == 0) {
+			return true; // empty line
+		}
+		if (numRows == 0) {
+			numCols = colsInRow;
+		}
+		else if (colsInRow != numCols) {
+			spdlog::error("Tilemap row {0} has {1} tiles, expected {2}", numRows, colsInRow, numCols);
+			return false;
+		}
+		numRows++;
+		colsInRow = 0;
+		return true;
+	};
+
+	for (char ch : buffer) {
+		if (ch >= '0' && ch <= '9') {
+			value = value * 10 + (ch - '0');
+			hasDigits = true;
+		}
+		else if (ch == ',') {
+			endTile();
+		}
+		else if (ch == '\n') {
+			if (!endRow()) {
+				return false;
+			}
+		}
+		// Anything else, like '\r' or spaces, is ignored
+	}
+	return endRow() && numRows > 0;
+}
+
+bool TilemapLoader::ParseBinary(const std::vector<char>& buffer, std::vector<uint16_t>& tiles, int& numCols, int& numRows) {
+	if (buffer.size() < BINARY_HEADER_SIZE || std::memcmp(buffer.data(), BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0) {
+		spdlog::error("Not a binary tilemap");
+		return false;
+	}
+	const uint32_t version = ReadUint32(buffer.data() + 4);
+	if (version != BINARY_VERSION) {
+		spdlog::error("Unsupported binary tilemap version {0}", version);
+		return false;
+	}
+	// Checked as read, a corrupt size must not turn into a huge or negative number of tiles
+	const uint32_t cols = ReadUint32(buffer.data() + 8);
+	const uint32_t rows = ReadUint32(buffer.data() + 12);
+	if (cols == 0 || rows == 0 || cols > MAX_SIZE || rows > MAX_SIZE) {
+		spdlog::error("Binary tilemap has an invalid size {0}x{1}", cols, rows);
+		return false;
+	}
+	numCols = static_cast<int>(cols);
+	numRows = static_cast<int>(rows);
+
+	const size_t numTiles = static_cast<size_t>(numCols) * numRows;
+	if ((buffer.size() - BINARY_HEADER_SIZE) / 2 < numTiles) {
+		spdlog::error("Binary tilemap is truncated");
+		return false;
+	}
+
+	tiles.resize(numTiles);
+	const auto* bytes = reinterpret_cast<const unsigned char*>(buffer.data() + BINARY_HEADER_SIZE);
+	for (size_t i = 0; i < numTiles; i++) {
+		tiles[i] = static_cast<uint16_t>(bytes[i * 2] | (bytes[i * 2 + 1] << 8));
+	}
+	return true;
+}
+
+bool TilemapLoader::Load(const std::string& filePath, Tilemap& tilemap, int tileSize, double tileScale, const std::string& tilesetAssetId) {
+	std::vector<char> buffer;
+	if (!ReadFile(filePath, buffer)) {
+		spdlog::error("Error opening the tilemap {0}", filePath);
+		return false;
+	}
+
+	std::vector<uint16_t> tiles;
+	int numCols, numRows;
+	const bool isParsed = EndsWith(filePath, ".tmap")
+		? ParseBinary(buffer, tiles, numCols, numRows)
+		: ParseText(buffer, tiles, numCols, numRows);
+	if (!isParsed) {
+		spdlog::error("Error parsing the tilemap {0}", filePath);
+		return false;
+	}
+
+	tilemap.Resize(numCols, numRows, tileSize, tileScale, tilesetAssetId);
+	for (int row = 0; row < numRows; row++) {
+		for (int col = 0; col < numCols; col++) {
+			tilemap.SetTile(col, row, tiles[static_cast<size_t>(row) * numCols + col]);
+		}
+	}
+
+	spdlog::info("Tilemap {0} loaded with {1}x{2} tiles", filePath, numCols, numRows);
+	return true;
+}
+
+bool TilemapLoader::SaveBinary(const std::string& filePath, const Tilemap& tilemap) {
+	std::vector<char> buffer(BINARY_MAGIC, BINARY_MAGIC + sizeof(BINARY_MAGIC));
+	WriteUint32(buffer, BINARY_VERSION);
+	WriteUint32(buffer, static_cast<uint32_t>(tilemap.GetNumCols()));
+	WriteUint32(buffer, static_cast<uint32_t>(tilemap.GetNumRows()));
+	for (int row = 0; row < tilemap.GetNumRows(); row++) {
+		for (int col = 0; col < tilemap.GetNumCols(); col++) {
+			const uint16_t tile = tilemap.GetTile(col, row);
+			buffer.push_back(static_cast<char>(tile & 0xFF));
+			buffer.push_back(static_cast<char>(tile >> 8));
+		}
+	}
+
+	std::ofstream file(filePath, std::ios::binary);
+	if (!file.write(buffer.data(), buffer.size())) {
+		spdlog::error("Error writing the binary tilemap {0}", filePath);
+		return false;
+	}
+	return true;
+}
+
+std::shared_ptr<TileCollisionLayer> TilemapLoader::BuildCollisionLayer(const Tilemap& tilemap, const std::set<int>& solidTileIds) {
+	auto collisionLayer = std::make_shared<TileCollisionLayer>(tilemap.GetNumCols(), tilemap.GetNumRows(), static_cast<float>(tilemap.GetTileSize() * tilemap.GetTileScale()));
+	for (int row = 0; row < tilemap.GetNumRows(); row++) {
+		for (int col = 0; col < tilemap.GetNumCols(); col++) {
+			if (solidTileIds.count(tilemap.GetTile(col, row))) {
+				collisionLayer->SetSolid(col, row);
+			}
+		}
+	}
+	return collisionLayer;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "Tilemap.h"
+#include "TileCollisionLayer.h"
+
+/////////////////////////////////////////////////////////////////////////////////
+// TilemapLoader
+/////////////////////////////////////////////////////////////////////////////////
+// Loads the tile ids of a Tilemap from disk. Two formats are supported:
+//  - Text (.map): rows of comma separated tile ids, e.g. "21,21,08,13". The size
+//    of the map is taken from the file. Used while editing the levels.
+//  - Binary (.tmap): the "TMAP" magic, a version, the number of columns and
+//    rows, then one little-endian uint16 per tile. Used for production.
+// The whole file is read with a single read and parsed from memory.
+/////////////////////////////////////////////////////////////////////////////////
+class TilemapLoader {
+private:
+	static bool ReadFile(const std::string& filePath, std::vector<char>& buffer);
+	static bool ParseText(const std::vector<char>& buffer, std::vector<uint16_t>& tiles, int& numCols, int& numRows);
+	static bool ParseBinary(const std::vector<char>& buffer, std::vector<uint16_t>& tiles, int& numCols, int& numRows);
+
+public:
+	static constexpr char BINARY_MAGIC[4] = { 'T', 'M', 'A', 'P' };
+	static constexpr uint32_t BINARY_VERSION = 1;
+	// Columns or rows of a map at most, larger worlds are streamed from a .tworld
+	static constexpr uint32_t MAX_SIZE = 1 << 14;
+
+	// Loads a .map or .tmap file depending on its extension, the map is read-only after it
+	static bool Load(const std::string& filePath, Tilemap& tilemap, int tileSize, double tileScale, const std::string& tilesetAssetId);
+
+	static bool SaveBinary(const std::string& filePath, const Tilemap& tilemap);
+
+	// The solidity of the tiles is kept in a bit grid instead of giving every tile a collider
+	static std::shared_ptr<TileCollisionLayer> BuildCollisionLayer(const Tilemap& tilemap, const std::set<int>& solidTileIds);
+};
@@ -0,0 +1,139 @@
+#include "TilemapRenderer.h"
+#include <algorithm>
+#include <cmath>
+#include <spdlog/spdlog.h>
+
+TilemapRenderer::~TilemapRenderer() {
+	Clear();
+}
+
+void TilemapRenderer::Clear() {
+	for (auto& chunk : chunks) {
+		if (chunk.texture) {
+			SDL_DestroyTexture(chunk.texture);
+		}
+	}
+	chunks.clear();
+	numChunkCols = 0;
+	numChunkRows = 0;
+}
+
+void TilemapRenderer::Invalidate() {
+	for (auto& chunk : chunks) {
+		chunk.isBaked = false;
+	}
+}
+
+void TilemapRenderer::BakeChunk(SDL_Renderer* renderer, const Tilemap& tilemap, const AssetStore& assetStore, int chunkCol, int chunkRow) {
+	// The chunk grid follows the size of the tilemap
+	if (numChunkCols != tilemap.GetNumChunkCols() || numChunkRows != tilemap.GetNumChunkRows()) {
+		Clear();
+		numChunkCols = tilemap.GetNumChunkCols();
+		numChunkRows = tilemap.GetNumChunkRows();
+		chunks.resize(static_cast<size_t>(numChunkCols) * numChunkRows);
+	}
+
+	auto& chunk = chunks[static_cast<size_t>(chunkRow) * numChunkCols + chunkCol];
+	const unsigned int revision = tilemap.GetChunkRevision(chunkCol, chunkRow);
+	if (chunk.isBaked && chunk.bakedRevision == revision) {
+		return;
+	}
+
+	// Tiles are baked at their original size, the scale of the map is applied when drawing the chunk
+	// The chunk stays unbaked until the tileset is loaded, it is baked in a later frame
+	const auto& region = assetStore.GetTextureRegion(tilemap.GetTilesetAssetId());
+	if (!region.isLoaded) {
+		return;
+	}
+
+	// The chunks of the right and bottom borders can be smaller than the rest
+	const int firstCol = chunkCol * Tilemap::CHUNK_SIZE;
+	const int firstRow = chunkRow * Tilemap::CHUNK_SIZE;
+	const int numCols = std::min(Tilemap::CHUNK_SIZE, tilemap.GetNumCols() - firstCol);
+	const int numRows = std::min(Tilemap::CHUNK_SIZE, tilemap.GetNumRows() - firstRow);
+	const int tileSize = tilemap.GetTileSize();
+
+	if (!chunk.texture) {
+		chunk.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, numCols * tileSize, numRows * tileSize);
+		if (!chunk.texture) {
+			spdlog::error("Error creating a tilemap chunk texture: {0}", SDL_GetError());
+			return;
+		}
+		SDL_SetTextureBlendMode(chunk.texture, SDL_BLENDMODE_BLEND);
+	}
+
+	SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+	SDL_SetRenderTarget(renderer, chunk.texture);
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+	SDL_RenderClear(renderer);
+
+	spriteBatch.Begin(renderer);
+	for (int row = 0; row < numRows; row++) {
+		for (int col = 0; col < numCols; col++) {
+			SDL_Rect srcRect = tilemap.GetTileSrcRect(tilemap.GetTile(firstCol + col, firstRow + row));
+			srcRect.x += region.rect.x;
+			srcRect.y += region.rect.y;
+			SDL_FRect dstRect = {
+				static_cast<float>(col * tileSize),
+				static_cast<float>(row * tileSize),
+				static_cast<float>(tileSize),
+				static_cast<float>(tileSize)
+			};
+			spriteBatch.Draw(region.texture, srcRect, dstRect);
+		}
+	}
+	spriteBatch.End();
+
+	SDL_SetRenderTarget(renderer, previousTarget);
+
+	chunk.bakedRevision = revision;
+	chunk.isBaked = true;
+	numChunksBaked++;
+}
+
+void TilemapRenderer::Render(SDL_Renderer* renderer, const Tilemap& tilemap, const AssetStore& assetStore, const Camera& camera) {
+	numChunksDrawn = 0;
+	if (tilemap.GetNumCols() == 0 || tilemap.GetNumRows() == 0) {
+		return;
+	}
+
+	// Range of chunks overlapped by the camera view
+	const float tileWorldSize = static_cast<float>(tilemap.GetTileSize() * tilemap.GetTileScale());
+	const float chunkWorldSize = Tilemap::CHUNK_SIZE * tileWorldSize;
+	const SDL_FRect view = camera.GetViewRect();
+	const int firstChunkCol = std::max(0, static_cast<int>(std::floor(view.x / chunkWorldSize)));
+	const int firstChunkRow = std::max(0, static_cast<int>(std::floor(view.y / chunkWorldSize)));
+	const int lastChunkCol = std::min(tilemap.GetNumChunkCols() - 1, static_cast<int>(std::floor((view.x + view.w) / chunkWorldSize)));
+	const int lastChunkRow = std::min(tilemap.GetNumChunkRows() - 1, static_cast<int>(std::floor((view.y + view.h) / chunkWorldSize)));
+
+	for (int chunkRow = firstChunkRow; chunkRow <= lastChunkRow; chunkRow++) {
+		for (int chunkCol = firstChunkCol; chunkCol <= lastChunkCol; chunkCol++) {
+			BakeChunk(renderer, tilemap, assetStore, chunkCol, chunkRow);
+
+			const auto& chunk = chunks[static_cast<size_t>(chunkRow) * numChunkCols + chunkCol];
+			if (!chunk.texture) {
+				continue;
+			}
+
+			int width, height;
+			SDL_QueryTexture(chunk.texture, NULL, NULL, &width, &height);
+			const glm::vec2 screenPosition = camera.WorldToScreen(glm::vec2(chunkCol * chunkWorldSize, chunkRow * chunkWorldSize));
+			SDL_FRect dstRect = {
+				screenPosition.x,
+				screenPosition.y,
+				static_cast<float>(width * tilemap.GetTileScale()),
+				static_cast<float>(height * tilemap.GetTileScale())
+			};
+			SDL_RenderCopyF(renderer, chunk.texture, NULL, &dstRect);
+			numChunksDrawn++;
+		}
+	}
+}
+
+int TilemapRenderer::GetNumChunksDrawn() const {
+	return numChunksDrawn;
+}
+
+int TilemapRenderer::GetNumChunksBaked() const {
+	return numChunksBaked;
+}
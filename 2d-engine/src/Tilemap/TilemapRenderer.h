@@ -0,0 +1,50 @@
+#pragma once
+#include <SDL.h>
+#include <memory>
+#include <vector>
+#include "Tilemap.h"
+#include "../AssetStore/AssetStore.h"
+#include "../Camera/Camera.h"
+#include "../Renderer/SpriteBatch.h"
+
+/////////////////////////////////////////////////////////////////////////////////
+// TilemapRenderer
+/////////////////////////////////////////////////////////////////////////////////
+// Bakes the tiles of every chunk of the tilemap into a render target texture,
+// so a visible chunk is drawn with a single copy instead of one per tile.
+// A chunk is baked again only when the revision of its tiles changes.
+/////////////////////////////////////////////////////////////////////////////////
+class TilemapRenderer {
+private:
+	struct Chunk {
+		SDL_Texture* texture = nullptr;
+		unsigned int bakedRevision = 0;
+		bool isBaked = false;
+	};
+
+	std::vector<Chunk> chunks;
+	int numChunkCols = 0;
+	int numChunkRows = 0;
+
+	SpriteBatch spriteBatch;
+	int numChunksDrawn = 0;
+	int numChunksBaked = 0;
+
+	void BakeChunk(SDL_Renderer* renderer, const Tilemap& tilemap, const AssetStore& assetStore, int chunkCol, int chunkRow);
+
+public:
+	TilemapRenderer() = default;
+	~TilemapRenderer();
+
+	// Destroy the chunk textures, must be called before the renderer is destroyed
+	void Clear();
+
+	// The textures of render targets can be lost by the renderer, bake everything again
+	void Invalidate();
+
+	// Draw the chunks inside the camera view, baking the ones that changed
+	void Render(SDL_Renderer* renderer, const Tilemap& tilemap, const AssetStore& assetStore, const Camera& camera);
+
+	int GetNumChunksDrawn() const;
+	int GetNumChunksBaked() const;
+};
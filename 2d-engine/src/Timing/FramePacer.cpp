@@ -0,0 +1,114 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+constexpr std::chrono::microseconds FramePacer::SPIN_MARGIN;
+constexpr size_t FramePacer::FRAME_HISTORY_SIZE;
+
+FramePacer::FramePacer(double framesPerSecond) {
+	SetTargetFrameRate(framesPerSecond);
+	frameTimesMs.reserve(FRAME_HISTORY_SIZE);
+}
+
+void FramePacer::SetTargetFrameRate(double framesPerSecond) {
+	targetFrameTime = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / std::max(1.0, framesPerSecond)));
+	isStarted = false;
+}
+
+FramePacer::Clock::duration FramePacer::GetTargetFrameTime() const {
+	return targetFrameTime;
+}
+
+void FramePacer::WaitForNextFrame() {
+	if (!isStarted) {
+		previousFrameTime = Clock::now();
+		nextFrameTime = previousFrameTime + targetFrameTime;
+		isStarted = true;
+		return;
+	}
+
+	SleepUntil(nextFrameTime);
+
+	const Clock::time_point now = Clock::now();
+	RecordFrame(std::chrono::duration<double, std::milli>(now - previousFrameTime).count());
+	previousFrameTime = now;
+
+	// A frame that missed its deadline by more than a whole frame does not make the next ones
+	// run back to back to catch up, the schedule starts again from now
+	nextFrameTime += targetFrameTime;
+	if (now - nextFrameTime > targetFrameTime) {
+		nextFrameTime = now + targetFrameTime;
+	}
+}
+
+void FramePacer::SleepUntil(Clock::time_point timePoint) {
+	const Clock::time_point sleepEnd = timePoint - SPIN_MARGIN;
+	if (Clock::now() < sleepEnd) {
+		std::this_thread::sleep_until(sleepEnd);
+	}
+	while (Clock::now() < timePoint) {
+		std::this_thread::yield();
+	}
+}
+
+void FramePacer::RecordFrame(double frameTimeMs) {
+	numFrames++;
+	const double diff = frameTimeMs - meanMs;
+	meanMs += diff / numFrames;
+	sumSquaredDiffMs += diff * (frameTimeMs - meanMs);
+	minMs = (numFrames == 1) ? frameTimeMs : std::min(minMs, frameTimeMs);
+	maxMs = (numFrames == 1) ? frameTimeMs : std::max(maxMs, frameTimeMs);
+
+	const double targetMs = std::chrono::duration<double, std::milli>(targetFrameTime).count();
+	if (frameTimeMs > targetMs * 1.1) {
+		numLateFrames++;
+	}
+
+	if (frameTimesMs.size() < FRAME_HISTORY_SIZE) {
+		frameTimesMs.push_back(static_cast<float>(frameTimeMs));
+	}
+	else {
+		frameTimesMs[nextFrameTimeIndex] = static_cast<float>(frameTimeMs);
+	}
+	nextFrameTimeIndex = (nextFrameTimeIndex + 1) % FRAME_HISTORY_SIZE;
+}
+
+FramePacer::FrameStats FramePacer::GetStats() const {
+	FrameStats stats;
+	stats.numFrames = numFrames;
+	stats.meanMs = meanMs;
+	stats.stdDevMs = numFrames > 1 ? std::sqrt(sumSquaredDiffMs / (numFrames - 1)) : 0.0;
+	stats.minMs = minMs;
+	stats.maxMs = maxMs;
+	stats.numLateFrames = numLateFrames;
+
+	if (!frameTimesMs.empty()) {
+		std::vector<float> sorted(frameTimesMs);
+		const size_t p99Index = (sorted.size() * 99) / 100;
+		std::nth_element(sorted.begin(), sorted.begin() + p99Index, sorted.end());
+		stats.p99Ms = sorted[p99Index];
+	}
+	return stats;
+}
+
+void FramePacer::ResetStats() {
+	numFrames = 0;
+	meanMs = 0.0;
+	sumSquaredDiffMs = 0.0;
+	minMs = 0.0;
+	maxMs = 0.0;
+	numLateFrames = 0;
+	frameTimesMs.clear();
+	nextFrameTimeIndex = 0;
+}
+
+void FramePacer::GetFrameTimeHistory(std::vector<float>& frameTimes) const {
+	frameTimes.clear();
+	if (frameTimesMs.size() < FRAME_HISTORY_SIZE) {
+		frameTimes = frameTimesMs;
+		return;
+	}
+	frameTimes.insert(frameTimes.end(), frameTimesMs.begin() + nextFrameTimeIndex, frameTimesMs.end());
+	frameTimes.insert(frameTimes.end(), frameTimesMs.begin(), frameTimesMs.begin() + nextFrameTimeIndex);
+}
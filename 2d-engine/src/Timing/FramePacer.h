@@ -0,0 +1,72 @@
+#pragma once
+#include <chrono>
+#include <vector>
+
+/////////////////////////////////////////////////////////////////////////////////
+// FramePacer
+/////////////////////////////////////////////////////////////////////////////////
+// Keeps a loop at a target frame rate with sub-millisecond precision. The wait
+// sleeps while the deadline is far and spins the last part, because a sleep
+// can overshoot by more than a millisecond. The deadlines advance by exactly
+// one frame time, so 60 FPS is 16.67 ms and not the 16 ms of integer math.
+// It also measures the time between frames to report its statistics.
+/////////////////////////////////////////////////////////////////////////////////
+class FramePacer {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	struct FrameStats {
+		int numFrames = 0;
+		double meanMs = 0.0;
+		double stdDevMs = 0.0;
+		double minMs = 0.0;
+		double maxMs = 0.0;
+		// Of the recent frames in the history
+		double p99Ms = 0.0;
+		// Frames that took 10% longer than the target
+		int numLateFrames = 0;
+	};
+
+private:
+	Clock::duration targetFrameTime;
+	Clock::time_point nextFrameTime;
+	Clock::time_point previousFrameTime;
+	bool isStarted = false;
+
+	// Running statistics of all the frames, Welford's algorithm
+	int numFrames = 0;
+	double meanMs = 0.0;
+	double sumSquaredDiffMs = 0.0;
+	double minMs = 0.0;
+	double maxMs = 0.0;
+	int numLateFrames = 0;
+
+	// Ring buffer of the recent frame times
+	std::vector<float> frameTimesMs;
+	size_t nextFrameTimeIndex = 0;
+
+	void RecordFrame(double frameTimeMs);
+
+public:
+	// Time before a deadline that is spun instead of slept
+	static constexpr std::chrono::microseconds SPIN_MARGIN { 2000 };
+	static constexpr size_t FRAME_HISTORY_SIZE = 240;
+
+	FramePacer(double framesPerSecond = 60.0);
+
+	void SetTargetFrameRate(double framesPerSecond);
+	Clock::duration GetTargetFrameTime() const;
+
+	// Waits until the deadline of the next frame and records the time of the frame that ended
+	void WaitForNextFrame();
+
+	// Frame statistics since the start, or since the last ResetStats
+	FrameStats GetStats() const;
+	void ResetStats();
+
+	// Recent frame times in milliseconds, the oldest first
+	void GetFrameTimeHistory(std::vector<float>& frameTimes) const;
+
+	// Sleeps coarsely and then spins until the time point
+	static void SleepUntil(Clock::time_point timePoint);
+};
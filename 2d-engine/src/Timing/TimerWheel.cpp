@@ -0,0 +1,153 @@
+#include "TimerWheel.h"
+#include <algorithm>
+
+constexpr int TimerWheel::SLOT_BITS;
+constexpr int TimerWheel::NUM_SLOTS;
+constexpr int TimerWheel::NUM_LEVELS;
+constexpr uint64_t TimerWheel::RANGE;
+
+TimerHandle TimerWheel::Schedule(uint32_t delayTicks, uint32_t periodTicks, uint64_t userData) {
+	int index;
+	if (!freeTimers.empty()) {
+		index = freeTimers.back();
+		freeTimers.pop_back();
+	}
+	else {
+		index = static_cast<int>(timers.size());
+		timers.emplace_back();
+	}
+
+	Timer& timer = timers[index];
+	timer.expireTick = currentTick + std::max<uint32_t>(delayTicks, 1);
+	timer.period = periodTicks;
+	timer.userData = userData;
+	numActiveTimers++;
+	Insert(index);
+
+	TimerHandle handle;
+	handle.index = index;
+	handle.generation = timer.generation;
+	return handle;
+}
+
+bool TimerWheel::Cancel(TimerHandle& handle) {
+	if (!IsPending(handle)) {
+		handle = TimerHandle();
+		return false;
+	}
+	if (timers[handle.index].slot >= 0) {
+		Remove(handle.index);
+	}
+	Release(handle.index);
+	handle = TimerHandle();
+	return true;
+}
+
+bool TimerWheel::IsPending(const TimerHandle& handle) const {
+	return handle.index >= 0 && handle.index < static_cast<int>(timers.size()) &&
+		timers[handle.index].slot != SLOT_FREE && timers[handle.index].generation == handle.generation;
+}
+
+uint64_t TimerWheel::GetUserData(const TimerHandle& handle) const {
+	return IsPending(handle) ? timers[handle.index].userData : 0;
+}
+
+void TimerWheel::Insert(int index) {
+	Timer& timer = timers[index];
+	// Past the range it waits in the farthest slot and is placed again when that slot comes
+	const uint64_t delay = std::min(timer.expireTick - currentTick, RANGE - 1);
+	const uint64_t expireTick = currentTick + delay;
+
+	int level = 0;
+	while (level < NUM_LEVELS - 1 && delay >= (uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+		level++;
+	}
+	const int slot = level * NUM_SLOTS + static_cast<int>((expireTick >> (SLOT_BITS * level)) & (NUM_SLOTS - 1));
+
+	timer.slot = slot;
+	timer.position = static_cast<int>(slots[slot].size());
+	slots[slot].push_back(index);
+}
+
+// The last timer of the slot takes its place
+void TimerWheel::Remove(int index) {
+	Timer& timer = timers[index];
+	std::vector<int>& slot = slots[timer.slot];
+	const int lastIndex = slot.back();
+	slot[timer.position] = lastIndex;
+	timers[lastIndex].position = timer.position;
+	slot.pop_back();
+	timer.slot = SLOT_FIRING;
+	timer.position = -1;
+}
+
+void TimerWheel::Release(int index) {
+	Timer& timer = timers[index];
+	timer.slot = SLOT_FREE;
+	timer.position = -1;
+	timer.generation++;
+	freeTimers.push_back(index);
+	numActiveTimers--;
+}
+
+// The timers of the current slot of a level move to the finer levels
+void TimerWheel::Cascade(int level) {
+	const int slot = level * NUM_SLOTS + static_cast<int>((currentTick >> (SLOT_BITS * level)) & (NUM_SLOTS - 1));
+	expiredIndices.clear();
+	expiredIndices.swap(slots[slot]);
+	for (int index : expiredIndices) {
+		Insert(index);
+	}
+	expiredIndices.clear();
+}
+
+void TimerWheel::CollectExpiredTimers() {
+	currentTick++;
+
+	// The coarser wheels turn when the finer ones wrap, the coarsest first so
+	// its timers can keep moving down in the same tick
+	int numWrappedLevels = 0;
+	while (numWrappedLevels < NUM_LEVELS - 1 && (currentTick & ((uint64_t(1) << (SLOT_BITS * (numWrappedLevels + 1))) - 1)) == 0) {
+		numWrappedLevels++;
+	}
+	for (int level = numWrappedLevels; level >= 1; level--) {
+		Cascade(level);
+	}
+
+	const int slot = static_cast<int>(currentTick & (NUM_SLOTS - 1));
+	expiredIndices.clear();
+	expiredIndices.swap(slots[slot]);
+	for (int index : expiredIndices) {
+		Timer& timer = timers[index];
+		timer.slot = SLOT_FIRING;
+		timer.position = -1;
+
+		TimerHandle handle;
+		handle.index = index;
+		handle.generation = timer.generation;
+		expiredTimers.push_back(handle);
+	}
+}
+
+void TimerWheel::FinishExpiredTimer(const TimerHandle& handle) {
+	// The callback may have cancelled it
+	if (!IsPending(handle)) {
+		return;
+	}
+	Timer& timer = timers[handle.index];
+	if (timer.period > 0) {
+		timer.expireTick = currentTick + timer.period;
+		Insert(handle.index);
+	}
+	else {
+		Release(handle.index);
+	}
+}
+
+uint64_t TimerWheel::GetCurrentTick() const {
+	return currentTick;
+}
+
+int TimerWheel::GetNumPendingTimers() const {
+	return numActiveTimers;
+}
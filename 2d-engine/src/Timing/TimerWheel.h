@@ -0,0 +1,115 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Identifies a scheduled timer, it goes stale once the timer is cancelled or fires for the last time
+struct TimerHandle {
+	int index = -1;
+	uint32_t generation = 0;
+
+	bool IsValid() const {
+		return index >= 0;
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////////
+// TimerWheel
+/////////////////////////////////////////////////////////////////////////////////
+// Timers counted in simulation ticks, kept in a hierarchical timing wheel:
+// NUM_LEVELS wheels of NUM_SLOTS slots, every level NUM_SLOTS times coarser
+// than the one below. A timer goes into the slot of its expiry tick in the
+// finest level that reaches it, and it moves down a level every time the
+// coarser wheel turns into its slot. Scheduling and cancelling are O(1): the
+// slots are arrays of timer indices, every timer knows its position in its
+// slot and a cancelled one is replaced by the last of the slot. A tick only
+// touches the timers that expire in it plus the ones that move down a level,
+// and it walks them as arrays instead of chasing the links of a list. Delays
+// past the range of the wheels wait in the last slot of the coarsest level.
+// The timers live in a pool reused through a free list, the handles carry a
+// generation so a stale handle never cancels the timer that reused its slot.
+/////////////////////////////////////////////////////////////////////////////////
+class TimerWheel {
+public:
+	static constexpr int SLOT_BITS = 6;
+	static constexpr int NUM_SLOTS = 1 << SLOT_BITS;
+	static constexpr int NUM_LEVELS = 4;
+	// Ticks reached by the wheels, 2^24 ticks are more than three days at 60 ticks/s
+	static constexpr uint64_t RANGE = uint64_t(1) << (SLOT_BITS * NUM_LEVELS);
+
+private:
+	static constexpr int SLOT_FIRING = -1;
+	static constexpr int SLOT_FREE = -2;
+
+	struct Timer {
+		uint64_t expireTick = 0;
+		// Ticks between firings, 0 fires once
+		uint32_t period = 0;
+		uint32_t generation = 0;
+		// Slot of the wheels and position in it, or one of the states below
+		int slot = SLOT_FREE;
+		int position = -1;
+		uint64_t userData = 0;
+	};
+
+	std::vector<Timer> timers;
+	std::vector<int> freeTimers;
+	int numActiveTimers = 0;
+
+	std::array<std::vector<int>, NUM_LEVELS * NUM_SLOTS> slots;
+
+	uint64_t currentTick = 0;
+	// The slot of the tick being advanced is swapped with these, no timer is copied
+	std::vector<int> expiredIndices;
+	std::vector<TimerHandle> expiredTimers;
+
+	void Insert(int index);
+	void Remove(int index);
+	void Release(int index);
+	void Cascade(int level);
+	void CollectExpiredTimers();
+	void FinishExpiredTimer(const TimerHandle& handle);
+
+public:
+	TimerWheel() = default;
+
+	TimerWheel(const TimerWheel&) = delete;
+	TimerWheel& operator =(const TimerWheel&) = delete;
+
+	// Fires after delayTicks ticks (at least 1), then every periodTicks ticks if it is not 0
+	// The user data is handed back when it fires, e.g. where the owner keeps what to do
+	TimerHandle Schedule(uint32_t delayTicks, uint32_t periodTicks, uint64_t userData);
+
+	// Returns false if the timer had already fired for the last time or been cancelled
+	bool Cancel(TimerHandle& handle);
+
+	bool IsPending(const TimerHandle& handle) const;
+	// Only valid while the timer is pending
+	uint64_t GetUserData(const TimerHandle& handle) const;
+
+	///////////////////////////////////////////////////////////////////////
+	// Advance one tick and fire the timers that expire in it
+	// onExpired(handle, userData, isRepeating) runs once per timer, and it
+	// can schedule and cancel timers, including the one that is firing.
+	// A timer that does not repeat is released right after its call
+	///////////////////////////////////////////////////////////////////////
+	template <typename TFunction>
+	void Advance(TFunction&& onExpired) {
+		CollectExpiredTimers();
+		for (size_t i = 0; i < expiredTimers.size(); i++) {
+			const TimerHandle handle = expiredTimers[i];
+			// Cancelled by another timer of the same tick
+			if (!IsPending(handle)) {
+				continue;
+			}
+			const Timer& timer = timers[handle.index];
+			onExpired(handle, timer.userData, timer.period > 0);
+			FinishExpiredTimer(handle);
+		}
+		expiredTimers.clear();
+	}
+
+	uint64_t GetCurrentTick() const;
+	int GetNumPendingTimers() const;
+};
@@ -0,0 +1,256 @@
+#include "WorldFile.h"
+#include "../Tilemap/Tilemap.h"
+#include <algorithm>
+#include <cstring>
+#include <spdlog/spdlog.h>
+
+constexpr char WorldFile::MAGIC[4];
+constexpr uint32_t WorldFile::VERSION;
+constexpr uint32_t WorldFile::MAX_SIZE;
+
+// Magic, version, columns, rows and chunk size
+const size_t HEADER_SIZE = 20;
+// Offset and number of spawns of a chunk
+const size_t CHUNK_ENTRY_SIZE = 12;
+// Type, padding, position and velocity of a spawn
+const size_t SPAWN_SIZE = 20;
+
+static uint32_t ReadUint32(const char* data) {
+	const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+	return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+static float ReadFloat(const char* data) {
+	const uint32_t bits = ReadUint32(data);
+	float value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+static void WriteUint32(std::vector<char>& buffer, uint32_t value) {
+	for (int i = 0; i < 4; i++) {
+		buffer.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+	}
+}
+
+static void WriteFloat(std::vector<char>& buffer, float value) {
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	WriteUint32(buffer, bits);
+}
+
+bool WorldFile::Open(const std::string& filePath) {
+	std::ifstream file(filePath, std::ios::binary);
+	if (!file) {
+		spdlog::error("Error opening the world {0}", filePath);
+		return false;
+	}
+
+	char header[HEADER_SIZE];
+	if (!file.read(header, HEADER_SIZE) || std::memcmp(header, MAGIC, sizeof(MAGIC)) != 0) {
+		spdlog::error("{0} is not a world file", filePath);
+		return false;
+	}
+	const uint32_t version = ReadUint32(header + 4);
+	const uint32_t chunkSize = ReadUint32(header + 16);
+	if (version != VERSION || chunkSize != Tilemap::CHUNK_SIZE) {
+		spdlog::error("Unsupported world {0}: version {1}, chunk size {2}", filePath, version, chunkSize);
+		return false;
+	}
+
+	// Everything read from the file is checked here, the streaming worker trusts the table
+	const uint32_t cols = ReadUint32(header + 8);
+	const uint32_t rows = ReadUint32(header + 12);
+	if (cols == 0 || rows == 0 || cols > MAX_SIZE || rows > MAX_SIZE) {
+		spdlog::error("The world {0} has an invalid size {1}x{2}", filePath, cols, rows);
+		return false;
+	}
+	numCols = static_cast<int>(cols);
+	numRows = static_cast<int>(rows);
+	numChunkCols = (numCols + Tilemap::CHUNK_SIZE - 1) / Tilemap::CHUNK_SIZE;
+	numChunkRows = (numRows + Tilemap::CHUNK_SIZE - 1) / Tilemap::CHUNK_SIZE;
+
+	file.seekg(0, std::ios::end);
+	const uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+	file.seekg(HEADER_SIZE);
+	const uint64_t tableSize = static_cast<uint64_t>(GetNumChunks()) * CHUNK_ENTRY_SIZE;
+	if (fileSize < HEADER_SIZE + tableSize) {
+		spdlog::error("The chunk table of the world {0} is truncated", filePath);
+		return false;
+	}
+
+	std::vector<char> table(static_cast<size_t>(tableSize));
+	if (!file.read(table.data(), table.size())) {
+		spdlog::error("The chunk table of the world {0} is truncated", filePath);
+		return false;
+	}
+	chunkTable.resize(GetNumChunks());
+	for (size_t i = 0; i < chunkTable.size(); i++) {
+		const char* entry = table.data() + i * CHUNK_ENTRY_SIZE;
+		chunkTable[i].offset = ReadUint32(entry) | (static_cast<uint64_t>(ReadUint32(entry + 4)) << 32);
+		chunkTable[i].numSpawns = ReadUint32(entry + 8);
+
+		// The tiles and the spawns of the chunk must lie between the table and the end of the file
+		const uint64_t tilesSize = static_cast<uint64_t>(GetChunkNumTiles(static_cast<int>(i))) * 2;
+		const uint64_t offset = chunkTable[i].offset;
+		if (offset < HEADER_SIZE + tableSize || offset > fileSize || fileSize - offset < tilesSize ||
+			(fileSize - offset - tilesSize) / SPAWN_SIZE < chunkTable[i].numSpawns) {
+			spdlog::error("The chunk {0} of the world {1} is out of the file", i, filePath);
+			chunkTable.clear();
+			return false;
+		}
+	}
+
+	this->filePath = filePath;
+	spdlog::info("World {0} opened with {1}x{2} tiles in {3} chunks", filePath, numCols, numRows, chunkTable.size());
+	return true;
+}
+
+bool WorldFile::ReadChunk(std::ifstream& file, int chunkIndex, ChunkData& chunk) const {
+	if (chunkIndex < 0 || chunkIndex >= GetNumChunks()) {
+		return false;
+	}
+	const ChunkEntry& entry = chunkTable[chunkIndex];
+
+	chunk.chunkIndex = chunkIndex;
+	chunk.chunkCol = chunkIndex % numChunkCols;
+	chunk.chunkRow = chunkIndex / numChunkCols;
+	GetChunkSize(chunkIndex, chunk.numCols, chunk.numRows);
+
+	// A single read for the tiles and the spawns of the chunk, Open checked that they fit in the file
+	const size_t numTiles = static_cast<size_t>(chunk.numCols) * chunk.numRows;
+	std::vector<char> buffer(numTiles * 2 + entry.numSpawns * SPAWN_SIZE);
+	file.clear();
+	file.seekg(static_cast<std::streamoff>(entry.offset));
+	if (!file.read(buffer.data(), buffer.size())) {
+		spdlog::error("Error reading the chunk {0} of the world {1}", chunkIndex, filePath);
+		return false;
+	}
+
+	const auto* bytes = reinterpret_cast<const unsigned char*>(buffer.data());
+	chunk.tiles.resize(numTiles);
+	for (size_t i = 0; i < numTiles; i++) {
+		chunk.tiles[i] = static_cast<uint16_t>(bytes[i * 2] | (bytes[i * 2 + 1] << 8));
+	}
+
+	chunk.spawns.resize(entry.numSpawns);
+	for (size_t i = 0; i < entry.numSpawns; i++) {
+		const char* data = buffer.data() + numTiles * 2 + i * SPAWN_SIZE;
+		chunk.spawns[i].type = static_cast<uint16_t>(ReadUint32(data) & 0xFFFF);
+		chunk.spawns[i].position = glm::vec2(ReadFloat(data + 4), ReadFloat(data + 8));
+		chunk.spawns[i].velocity = glm::vec2(ReadFloat(data + 12), ReadFloat(data + 16));
+	}
+	return true;
+}
+
+// The chunks of the right and bottom borders can be smaller than the rest
+void WorldFile::GetChunkSize(int chunkIndex, int& chunkNumCols, int& chunkNumRows) const {
+	chunkNumCols = std::min(Tilemap::CHUNK_SIZE, numCols - (chunkIndex % numChunkCols) * Tilemap::CHUNK_SIZE);
+	chunkNumRows = std::min(Tilemap::CHUNK_SIZE, numRows - (chunkIndex / numChunkCols) * Tilemap::CHUNK_SIZE);
+}
+
+int WorldFile::GetChunkNumTiles(int chunkIndex) const {
+	int chunkNumCols, chunkNumRows;
+	GetChunkSize(chunkIndex, chunkNumCols, chunkNumRows);
+	return chunkNumCols * chunkNumRows;
+}
+
+const std::string& WorldFile::GetFilePath() const {
+	return filePath;
+}
+
+int WorldFile::GetNumCols() const {
+	return numCols;
+}
+
+int WorldFile::GetNumRows() const {
+	return numRows;
+}
+
+int WorldFile::GetNumChunkCols() const {
+	return numChunkCols;
+}
+
+int WorldFile::GetNumChunkRows() const {
+	return numChunkRows;
+}
+
+int WorldFile::GetNumChunks() const {
+	return numChunkCols * numChunkRows;
+}
+
+bool WorldFile::Write(
+	const std::string& filePath,
+	int numCols,
+	int numRows,
+	const std::function<uint16_t(int col, int row)>& getTile,
+	const std::function<void(int chunkCol, int chunkRow, std::vector<ChunkSpawn>& spawns)>& getSpawns
+) {
+	std::ofstream file(filePath, std::ios::binary);
+	if (!file) {
+		spdlog::error("Error creating the world {0}", filePath);
+		return false;
+	}
+
+	const int numChunkCols = (numCols + Tilemap::CHUNK_SIZE - 1) / Tilemap::CHUNK_SIZE;
+	const int numChunkRows = (numRows + Tilemap::CHUNK_SIZE - 1) / Tilemap::CHUNK_SIZE;
+	const size_t numChunks = static_cast<size_t>(numChunkCols) * numChunkRows;
+
+	std::vector<char> buffer(MAGIC, MAGIC + sizeof(MAGIC));
+	WriteUint32(buffer, VERSION);
+	WriteUint32(buffer, static_cast<uint32_t>(numCols));
+	WriteUint32(buffer, static_cast<uint32_t>(numRows));
+	WriteUint32(buffer, static_cast<uint32_t>(Tilemap::CHUNK_SIZE));
+	file.write(buffer.data(), buffer.size());
+
+	// The table is filled while the chunks are written and stored at the end
+	std::vector<char> table;
+	table.reserve(numChunks * CHUNK_ENTRY_SIZE);
+	uint64_t offset = HEADER_SIZE + numChunks * CHUNK_ENTRY_SIZE;
+	file.seekp(static_cast<std::streamoff>(offset));
+
+	std::vector<ChunkSpawn> spawns;
+	for (int chunkRow = 0; chunkRow < numChunkRows; chunkRow++) {
+		for (int chunkCol = 0; chunkCol < numChunkCols; chunkCol++) {
+			const int firstCol = chunkCol * Tilemap::CHUNK_SIZE;
+			const int firstRow = chunkRow * Tilemap::CHUNK_SIZE;
+			const int chunkNumCols = std::min(Tilemap::CHUNK_SIZE, numCols - firstCol);
+			const int chunkNumRows = std::min(Tilemap::CHUNK_SIZE, numRows - firstRow);
+
+			buffer.clear();
+			for (int row = 0; row < chunkNumRows; row++) {
+				for (int col = 0; col < chunkNumCols; col++) {
+					const uint16_t tile = getTile(firstCol + col, firstRow + row);
+					buffer.push_back(static_cast<char>(tile & 0xFF));
+					buffer.push_back(static_cast<char>(tile >> 8));
+				}
+			}
+
+			spawns.clear();
+			getSpawns(chunkCol, chunkRow, spawns);
+			for (const auto& spawn : spawns) {
+				WriteUint32(buffer, spawn.type);
+				WriteFloat(buffer, spawn.position.x);
+				WriteFloat(buffer, spawn.position.y);
+				WriteFloat(buffer, spawn.velocity.x);
+				WriteFloat(buffer, spawn.velocity.y);
+			}
+
+			WriteUint32(table, static_cast<uint32_t>(offset & 0xFFFFFFFF));
+			WriteUint32(table, static_cast<uint32_t>(offset >> 32));
+			WriteUint32(table, static_cast<uint32_t>(spawns.size()));
+
+			file.write(buffer.data(), buffer.size());
+			offset += buffer.size();
+		}
+	}
+
+	file.seekp(static_cast<std::streamoff>(HEADER_SIZE));
+	file.write(table.data(), table.size());
+	if (!file) {
+		spdlog::error("Error writing the world {0}", filePath);
+		return false;
+	}
+	spdlog::info("World {0} written with {1}x{2} tiles in {3} chunks", filePath, numCols, numRows, numChunks);
+	return true;
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Units placed in the world file, they are spawned when their chunk is loaded
+enum SpawnType : uint16_t {
+	SPAWN_TANK = 0,
+	SPAWN_TRUCK = 1
+};
+
+struct ChunkSpawn {
+	uint16_t type = SPAWN_TANK;
+	glm::vec2 position = glm::vec2(0.0);
+	glm::vec2 velocity = glm::vec2(0.0);
+};
+
+// The decoded content of one chunk of the world
+struct ChunkData {
+	int chunkIndex = -1;
+	int chunkCol = 0;
+	int chunkRow = 0;
+	int numCols = 0;
+	int numRows = 0;
+	// Row major [index = row * numCols + col]
+	std::vector<uint16_t> tiles;
+	std::vector<ChunkSpawn> spawns;
+};
+
+/////////////////////////////////////////////////////////////////////////////////
+// WorldFile
+/////////////////////////////////////////////////////////////////////////////////
+// A tilemap stored by chunks of Tilemap::CHUNK_SIZE tiles so any chunk can be
+// read without touching the rest of the file (.tworld):
+//  - Header: the "TWLD" magic, a version, the number of columns and rows and
+//    the chunk size, all of them little-endian uint32.
+//  - Chunk table: offset (uint64) and number of spawns (uint32) of every chunk.
+//  - Chunks: one uint16 per tile followed by the spawns of the chunk.
+// Only the header and the table are kept in memory. ReadChunk is const and can
+// be called from another thread, every thread reads with its own stream.
+/////////////////////////////////////////////////////////////////////////////////
+class WorldFile {
+private:
+	struct ChunkEntry {
+		uint64_t offset = 0;
+		uint32_t numSpawns = 0;
+	};
+
+	std::string filePath;
+	int numCols = 0;
+	int numRows = 0;
+	int numChunkCols = 0;
+	int numChunkRows = 0;
+	std::vector<ChunkEntry> chunkTable;
+
+	void GetChunkSize(int chunkIndex, int& chunkNumCols, int& chunkNumRows) const;
+	int GetChunkNumTiles(int chunkIndex) const;
+
+public:
+	static constexpr char MAGIC[4] = { 'T', 'W', 'L', 'D' };
+	static constexpr uint32_t VERSION = 1;
+	// Columns or rows of a world at most
+	static constexpr uint32_t MAX_SIZE = 1 << 16;
+
+	WorldFile() = default;
+
+	// Reads the header and the chunk table, false if any chunk does not fit in the file
+	bool Open(const std::string& filePath);
+
+	bool ReadChunk(std::ifstream& file, int chunkIndex, ChunkData& chunk) const;
+
+	const std::string& GetFilePath() const;
+	int GetNumCols() const;
+	int GetNumRows() const;
+	int GetNumChunkCols() const;
+	int GetNumChunkRows() const;
+	int GetNumChunks() const;
+
+	// Writes a world chunk by chunk, the whole map never needs to be in memory
+	static bool Write(
+		const std::string& filePath,
+		int numCols,
+		int numRows,
+		const std::function<uint16_t(int col, int row)>& getTile,
+		const std::function<void(int chunkCol, int chunkRow, std::vector<ChunkSpawn>& spawns)>& getSpawns
+	);
+};
@@ -0,0 +1,449 @@
+#include "WorldStreamer.h"
+#include "../Components/StreamedComponent.h"
+#include "../Tilemap/Tilemap.h"
+#include <SDL_image.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <spdlog/spdlog.h>
+
+constexpr size_t WorldStreamer::DEFAULT_MEMORY_BUDGET;
+
+WorldStreamer::~WorldStreamer() {
+	Close();
+}
+
+bool WorldStreamer::Open(const std::string& worldFilePath, const std::string& tilesetFilePath, int tileSize, double tileScale) {
+	Close();
+
+	if (!worldFile.Open(worldFilePath)) {
+		return false;
+	}
+
+	// Without a tileset the chunks are not baked, e.g. when running headless
+	if (!tilesetFilePath.empty()) {
+		SDL_Surface* surface = IMG_Load(tilesetFilePath.c_str());
+		if (!surface) {
+			spdlog::error("Error loading the tileset {0}: {1}", tilesetFilePath, IMG_GetError());
+			return false;
+		}
+		tilesetSurface = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+		SDL_FreeSurface(surface);
+		if (!tilesetSurface) {
+			spdlog::error("Error converting the tileset {0}: {1}", tilesetFilePath, SDL_GetError());
+			return false;
+		}
+		// The tiles are copied as they are into the transparent chunk surfaces
+		SDL_SetSurfaceBlendMode(tilesetSurface, SDL_BLENDMODE_NONE);
+	}
+
+	this->tileSize = tileSize;
+	this->tileScale = tileScale;
+	isStopping = false;
+	worker = std::thread(&WorldStreamer::WorkerLoop, this);
+	return true;
+}
+
+void WorldStreamer::Close(bool killEntities) {
+	if (worker.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			isStopping = true;
+			requestedChunks.clear();
+		}
+		condition.notify_all();
+		worker.join();
+	}
+
+	for (auto& bakedChunk : bakedChunks) {
+		SDL_FreeSurface(bakedChunk.surface);
+	}
+	bakedChunks.clear();
+
+	while (!lruChunks.empty()) {
+		EvictChunk(lruChunks.back(), killEntities);
+	}
+	wantedChunks.clear();
+
+	for (auto& operation : textureOperations) {
+		SDL_FreeSurface(operation.surface);
+	}
+	textureOperations.clear();
+	for (auto& chunkTexture : chunkTextures) {
+		SDL_DestroyTexture(chunkTexture.second);
+	}
+	chunkTextures.clear();
+
+	if (tilesetSurface) {
+		SDL_FreeSurface(tilesetSurface);
+		tilesetSurface = nullptr;
+	}
+}
+
+void WorldStreamer::SetMemoryBudget(size_t memoryBudget) {
+	this->memoryBudget = memoryBudget;
+}
+
+void WorldStreamer::SetPrefetchChunks(int prefetchChunks) {
+	this->prefetchChunks = std::max(0, prefetchChunks);
+}
+
+void WorldStreamer::SetMaxUploadsPerFrame(int maxUploadsPerFrame) {
+	this->maxUploadsPerFrame = std::max(1, maxUploadsPerFrame);
+}
+
+void WorldStreamer::SetSynchronous(bool isSynchronous) {
+	this->isSynchronous = isSynchronous;
+}
+
+void WorldStreamer::SetTileCollisionLayer(std::shared_ptr<TileCollisionLayer> collisionLayer, const std::set<int>& solidTileIds) {
+	this->collisionLayer = collisionLayer;
+	isSolidTile.assign(solidTileIds.empty() ? 0 : *solidTileIds.rbegin() + 1, false);
+	for (int tileId : solidTileIds) {
+		isSolidTile[tileId] = true;
+	}
+}
+
+void WorldStreamer::SetSpawnFunction(SpawnFunction spawnFunction) {
+	this->spawnFunction = spawnFunction;
+}
+
+void WorldStreamer::WorkerLoop() {
+	// Every thread reading the world needs its own stream
+	std::ifstream file(worldFile.GetFilePath(), std::ios::binary);
+
+	while (true) {
+		int chunkIndex;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait(lock, [this]() { return isStopping || !requestedChunks.empty(); });
+			if (isStopping) {
+				return;
+			}
+			chunkIndex = requestedChunks.front();
+			requestedChunks.pop_front();
+			loadingChunk = chunkIndex;
+		}
+
+		BakedChunk bakedChunk;
+		const bool isRead = worldFile.ReadChunk(file, chunkIndex, bakedChunk.data);
+		if (isRead && tilesetSurface) {
+			bakedChunk.surface = BakeSurface(bakedChunk.data);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			loadingChunk = -1;
+			if (isRead) {
+				bakedChunks.push_back(std::move(bakedChunk));
+			}
+		}
+		loadedCondition.notify_all();
+	}
+}
+
+SDL_Surface* WorldStreamer::BakeSurface(const ChunkData& chunk) const {
+	// Tiles are baked at their original size, the scale of the map is applied when drawing the chunk
+	SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, chunk.numCols * tileSize, chunk.numRows * tileSize, 32, SDL_PIXELFORMAT_RGBA32);
+	if (!surface) {
+		return nullptr;
+	}
+	for (int row = 0; row < chunk.numRows; row++) {
+		for (int col = 0; col < chunk.numCols; col++) {
+			const uint16_t tileId = chunk.tiles[static_cast<size_t>(row) * chunk.numCols + col];
+			SDL_Rect srcRect = {
+				(tileId % Tilemap::TILESET_ID_BASE) * tileSize,
+				(tileId / Tilemap::TILESET_ID_BASE) * tileSize,
+				tileSize,
+				tileSize
+			};
+			SDL_Rect dstRect = { col * tileSize, row * tileSize, tileSize, tileSize };
+			SDL_BlitSurface(tilesetSurface, &srcRect, surface, &dstRect);
+		}
+	}
+	return surface;
+}
+
+void WorldStreamer::InstallChunk(BakedChunk& bakedChunk) {
+	const ChunkData& chunk = bakedChunk.data;
+	if (residentChunks.count(chunk.chunkIndex)) {
+		SDL_FreeSurface(bakedChunk.surface);
+		return;
+	}
+
+	// Textures can only be created on the thread of the renderer
+	if (bakedChunk.surface) {
+		std::lock_guard<std::mutex> lock(textureMutex);
+		textureOperations.push_back({ chunk.chunkIndex, bakedChunk.surface });
+		bakedChunk.surface = nullptr;
+	}
+
+	ResidentChunk& resident = residentChunks[chunk.chunkIndex];
+	resident.memoryBytes = static_cast<size_t>(chunk.numCols) * chunk.numRows * tileSize * tileSize * 4;
+	lruChunks.push_front(chunk.chunkIndex);
+	resident.lruPosition = lruChunks.begin();
+	memoryBytes += resident.memoryBytes;
+
+	MarkSolidTiles(chunk);
+
+	if (spawnFunction) {
+		for (const auto& spawn : chunk.spawns) {
+			Entity entity = spawnFunction(spawn);
+			entity.AddComponent<StreamedComponent>(chunk.chunkIndex);
+			resident.entities.push_back(entity);
+		}
+	}
+	numChunksLoaded++;
+}
+
+void WorldStreamer::EvictChunk(int chunkIndex, bool killEntities) {
+	auto resident = residentChunks.find(chunkIndex);
+	if (resident == residentChunks.end()) {
+		return;
+	}
+
+	if (killEntities) {
+		for (auto entity : resident->second.entities) {
+			// The entity may have been killed already and its id given to another entity
+			if (entity.HasComponent<StreamedComponent>() && entity.GetComponent<StreamedComponent>().chunkIndex == chunkIndex) {
+				entity.Kill();
+			}
+		}
+	}
+
+	ClearSolidTiles(chunkIndex);
+	if (tilesetSurface) {
+		std::lock_guard<std::mutex> lock(textureMutex);
+		textureOperations.push_back({ chunkIndex, nullptr });
+	}
+	memoryBytes -= resident->second.memoryBytes;
+	lruChunks.erase(resident->second.lruPosition);
+	residentChunks.erase(resident);
+	numChunksEvicted++;
+}
+
+void WorldStreamer::MarkSolidTiles(const ChunkData& chunk) {
+	if (!collisionLayer) {
+		return;
+	}
+	const int firstCol = chunk.chunkCol * Tilemap::CHUNK_SIZE;
+	const int firstRow = chunk.chunkRow * Tilemap::CHUNK_SIZE;
+	for (int row = 0; row < chunk.numRows; row++) {
+		for (int col = 0; col < chunk.numCols; col++) {
+			const uint16_t tileId = chunk.tiles[static_cast<size_t>(row) * chunk.numCols + col];
+			if (tileId < isSolidTile.size() && isSolidTile[tileId]) {
+				collisionLayer->SetSolid(firstCol + col, firstRow + row);
+			}
+		}
+	}
+}
+
+void WorldStreamer::ClearSolidTiles(int chunkIndex) {
+	if (!collisionLayer) {
+		return;
+	}
+	const int firstCol = (chunkIndex % worldFile.GetNumChunkCols()) * Tilemap::CHUNK_SIZE;
+	const int firstRow = (chunkIndex / worldFile.GetNumChunkCols()) * Tilemap::CHUNK_SIZE;
+	const int lastCol = std::min(firstCol + Tilemap::CHUNK_SIZE, worldFile.GetNumCols());
+	const int lastRow = std::min(firstRow + Tilemap::CHUNK_SIZE, worldFile.GetNumRows());
+	for (int row = firstRow; row < lastRow; row++) {
+		for (int col = firstCol; col < lastCol; col++) {
+			collisionLayer->SetSolid(col, row, false);
+		}
+	}
+}
+
+bool WorldStreamer::GetChunkRange(const SDL_FRect& area, int& firstChunkCol, int& firstChunkRow, int& lastChunkCol, int& lastChunkRow) const {
+	const float chunkWorldSize = static_cast<float>(Tilemap::CHUNK_SIZE * tileSize * tileScale);
+	firstChunkCol = std::max(0, static_cast<int>(std::floor(area.x / chunkWorldSize)));
+	firstChunkRow = std::max(0, static_cast<int>(std::floor(area.y / chunkWorldSize)));
+	lastChunkCol = std::min(worldFile.GetNumChunkCols() - 1, static_cast<int>(std::floor((area.x + area.w) / chunkWorldSize)));
+	lastChunkRow = std::min(worldFile.GetNumChunkRows() - 1, static_cast<int>(std::floor((area.y + area.h) / chunkWorldSize)));
+	return firstChunkCol <= lastChunkCol && firstChunkRow <= lastChunkRow;
+}
+
+void WorldStreamer::Update(const Camera& camera) {
+	if (!worker.joinable()) {
+		return;
+	}
+
+	// The chunks in the view and the prefetch ring, nearest to the center of the view first
+	const SDL_FRect view = camera.GetViewRect();
+	const float chunkWorldSize = static_cast<float>(Tilemap::CHUNK_SIZE * tileSize * tileScale);
+	const float margin = prefetchChunks * chunkWorldSize;
+	const SDL_FRect area = { view.x - margin, view.y - margin, view.w + margin * 2, view.h + margin * 2 };
+	const float centerX = (view.x + view.w * 0.5f) / chunkWorldSize - 0.5f;
+	const float centerY = (view.y + view.h * 0.5f) / chunkWorldSize - 0.5f;
+
+	wantedChunks.clear();
+	int firstChunkCol, firstChunkRow, lastChunkCol, lastChunkRow;
+	if (GetChunkRange(area, firstChunkCol, firstChunkRow, lastChunkCol, lastChunkRow)) {
+		for (int chunkRow = firstChunkRow; chunkRow <= lastChunkRow; chunkRow++) {
+			for (int chunkCol = firstChunkCol; chunkCol <= lastChunkCol; chunkCol++) {
+				wantedChunks.push_back(chunkRow * worldFile.GetNumChunkCols() + chunkCol);
+			}
+		}
+	}
+	const int numChunkCols = worldFile.GetNumChunkCols();
+	std::sort(wantedChunks.begin(), wantedChunks.end(), [&](int a, int b) {
+		const float ax = a % numChunkCols - centerX, ay = a / numChunkCols - centerY;
+		const float bx = b % numChunkCols - centerX, by = b / numChunkCols - centerY;
+		return ax * ax + ay * ay < bx * bx + by * by;
+	});
+
+	// Mark the wanted chunks as recently seen, walking backwards leaves the nearest at the front
+	for (auto it = wantedChunks.rbegin(); it != wantedChunks.rend(); ++it) {
+		auto resident = residentChunks.find(*it);
+		if (resident != residentChunks.end()) {
+			lruChunks.splice(lruChunks.begin(), lruChunks, resident->second.lruPosition);
+		}
+	}
+
+	// Take the finished chunks and replace the requests, the ones out of range are dropped before being read
+	std::vector<BakedChunk> finishedChunks;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		finishedChunks.swap(bakedChunks);
+
+		std::set<int> pendingChunks = { loadingChunk };
+		for (const auto& bakedChunk : finishedChunks) {
+			pendingChunks.insert(bakedChunk.data.chunkIndex);
+		}
+
+		requestedChunks.clear();
+		for (int chunkIndex : wantedChunks) {
+			if (!residentChunks.count(chunkIndex) && !pendingChunks.count(chunkIndex)) {
+				requestedChunks.push_back(chunkIndex);
+			}
+		}
+	}
+	condition.notify_one();
+
+	// Nothing is left pending between the steps, the chunks come in the order they were requested
+	if (isSynchronous) {
+		std::unique_lock<std::mutex> lock(mutex);
+		loadedCondition.wait(lock, [this]() { return requestedChunks.empty() && loadingChunk == -1; });
+		std::move(bakedChunks.begin(), bakedChunks.end(), std::back_inserter(finishedChunks));
+		bakedChunks.clear();
+	}
+
+	for (auto& bakedChunk : finishedChunks) {
+		InstallChunk(bakedChunk);
+	}
+
+	// Evict the least recently seen chunks, never the ones in range
+	// A chunk in range is skipped, not a stop: a chunk installed this frame can be ahead of it
+	// in the list and already out of range, the walk goes on until the budget is met
+	std::set<int> inRange(wantedChunks.begin(), wantedChunks.end());
+	auto it = lruChunks.end();
+	while (memoryBytes > memoryBudget && it != lruChunks.begin()) {
+		--it;
+		if (inRange.count(*it)) {
+			continue;
+		}
+		const int chunkIndex = *it;
+		it = std::next(it);
+		EvictChunk(chunkIndex, true);
+	}
+}
+
+void WorldStreamer::Render(SDL_Renderer* renderer, const Camera& camera) {
+	// Apply the texture operations in order, a chunk can be evicted and loaded again before being drawn
+	int numUploads = 0;
+	while (numUploads < maxUploadsPerFrame) {
+		TextureOperation operation;
+		{
+			std::lock_guard<std::mutex> lock(textureMutex);
+			if (textureOperations.empty()) {
+				break;
+			}
+			operation = textureOperations.front();
+			textureOperations.pop_front();
+		}
+
+		auto chunkTexture = chunkTextures.find(operation.chunkIndex);
+		if (chunkTexture != chunkTextures.end()) {
+			SDL_DestroyTexture(chunkTexture->second);
+			chunkTextures.erase(chunkTexture);
+		}
+		if (!operation.surface) {
+			continue;
+		}
+
+		SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, operation.surface);
+		SDL_FreeSurface(operation.surface);
+		if (!texture) {
+			spdlog::error("Error creating the texture of the world chunk {0}: {1}", operation.chunkIndex, SDL_GetError());
+			continue;
+		}
+		chunkTextures[operation.chunkIndex] = texture;
+		numUploads++;
+	}
+
+	numChunksDrawn = 0;
+
+	int firstChunkCol, firstChunkRow, lastChunkCol, lastChunkRow;
+	if (!GetChunkRange(camera.GetViewRect(), firstChunkCol, firstChunkRow, lastChunkCol, lastChunkRow)) {
+		return;
+	}
+
+	const float chunkWorldSize = static_cast<float>(Tilemap::CHUNK_SIZE * tileSize * tileScale);
+	for (int chunkRow = firstChunkRow; chunkRow <= lastChunkRow; chunkRow++) {
+		for (int chunkCol = firstChunkCol; chunkCol <= lastChunkCol; chunkCol++) {
+			// A chunk that is still being loaded is not drawn
+			auto chunkTexture = chunkTextures.find(chunkRow * worldFile.GetNumChunkCols() + chunkCol);
+			if (chunkTexture == chunkTextures.end()) {
+				continue;
+			}
+
+			int width, height;
+			SDL_QueryTexture(chunkTexture->second, NULL, NULL, &width, &height);
+			const glm::vec2 screenPosition = camera.WorldToScreen(glm::vec2(chunkCol * chunkWorldSize, chunkRow * chunkWorldSize));
+			SDL_FRect dstRect = {
+				screenPosition.x,
+				screenPosition.y,
+				static_cast<float>(width * tileScale),
+				static_cast<float>(height * tileScale)
+			};
+			SDL_RenderCopyF(renderer, chunkTexture->second, NULL, &dstRect);
+			numChunksDrawn++;
+		}
+	}
+}
+
+int WorldStreamer::GetNumCols() const {
+	return worldFile.GetNumCols();
+}
+
+int WorldStreamer::GetNumRows() const {
+	return worldFile.GetNumRows();
+}
+
+float WorldStreamer::GetWorldWidth() const {
+	return static_cast<float>(worldFile.GetNumCols() * tileSize * tileScale);
+}
+
+float WorldStreamer::GetWorldHeight() const {
+	return static_cast<float>(worldFile.GetNumRows() * tileSize * tileScale);
+}
+
+int WorldStreamer::GetNumResidentChunks() const {
+	return static_cast<int>(residentChunks.size());
+}
+
+size_t WorldStreamer::GetMemoryBytes() const {
+	return memoryBytes;
+}
+
+int WorldStreamer::GetNumChunksDrawn() const {
+	return numChunksDrawn;
+}
+
+int WorldStreamer::GetNumChunksLoaded() const {
+	return numChunksLoaded;
+}
+
+int WorldStreamer::GetNumChunksEvicted() const {
+	return numChunksEvicted;
+}
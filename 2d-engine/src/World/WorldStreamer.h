@@ -0,0 +1,148 @@
+#pragma once
+#include <SDL.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "WorldFile.h"
+#include "../ECS/ECS.h"
+#include "../Camera/Camera.h"
+#include "../Tilemap/TileCollisionLayer.h"
+
+/////////////////////////////////////////////////////////////////////////////////
+// WorldStreamer
+/////////////////////////////////////////////////////////////////////////////////
+// Keeps in memory only the chunks of a WorldFile around the camera. A worker
+// thread reads, decodes and bakes the tiles of a chunk into a surface, then the
+// simulation marks its solid tiles in the collision layer and spawns its units,
+// and the render thread uploads the surface as a texture. When the resident
+// chunks go over the memory budget the least recently seen ones that are out
+// of range are evicted, with their textures, their solid tiles and the entities
+// they spawned.
+/////////////////////////////////////////////////////////////////////////////////
+class WorldStreamer {
+public:
+	using SpawnFunction = std::function<Entity(const ChunkSpawn& spawn)>;
+
+private:
+	// A chunk decoded by the worker, waiting to be uploaded by the main thread
+	struct BakedChunk {
+		ChunkData data;
+		SDL_Surface* surface = nullptr;
+	};
+
+	// A texture to create from the surface, or to destroy if there is no surface
+	struct TextureOperation {
+		int chunkIndex;
+		SDL_Surface* surface;
+	};
+
+	struct ResidentChunk {
+		std::vector<Entity> entities;
+		std::list<int>::iterator lruPosition;
+		size_t memoryBytes = 0;
+	};
+
+	WorldFile worldFile;
+	SDL_Surface* tilesetSurface = nullptr;
+	int tileSize = 32;
+	double tileScale = 1.0;
+
+	// Shared with the worker thread, guarded by the mutex
+	std::thread worker;
+	std::mutex mutex;
+	std::condition_variable condition;
+	// Notified by the worker every time it finishes a chunk
+	std::condition_variable loadedCondition;
+	std::deque<int> requestedChunks;
+	std::vector<BakedChunk> bakedChunks;
+	int loadingChunk = -1;
+	bool isStopping = false;
+
+	// Handed from the simulation to the render thread, guarded by the textureMutex
+	std::mutex textureMutex;
+	std::deque<TextureOperation> textureOperations;
+
+	// Only used by the render thread
+	std::unordered_map<int, SDL_Texture*> chunkTextures;
+
+	// Only used by the simulation
+	std::unordered_map<int, ResidentChunk> residentChunks;
+	std::list<int> lruChunks; // Most recently seen first
+	std::vector<int> wantedChunks;
+	size_t memoryBytes = 0;
+	size_t memoryBudget = DEFAULT_MEMORY_BUDGET;
+	int prefetchChunks = 1;
+	int maxUploadsPerFrame = 4;
+	bool isSynchronous = false;
+
+	std::shared_ptr<TileCollisionLayer> collisionLayer;
+	std::vector<bool> isSolidTile;
+	SpawnFunction spawnFunction;
+
+	int numChunksDrawn = 0;
+	int numChunksLoaded = 0;
+	int numChunksEvicted = 0;
+
+	void WorkerLoop();
+	SDL_Surface* BakeSurface(const ChunkData& chunk) const;
+
+	void InstallChunk(BakedChunk& bakedChunk);
+	void EvictChunk(int chunkIndex, bool killEntities);
+	void MarkSolidTiles(const ChunkData& chunk);
+	void ClearSolidTiles(int chunkIndex);
+
+	// Range of chunks [firstChunkCol..lastChunkCol] x [firstChunkRow..lastChunkRow] overlapped by an area of the world
+	bool GetChunkRange(const SDL_FRect& area, int& firstChunkCol, int& firstChunkRow, int& lastChunkCol, int& lastChunkRow) const;
+
+public:
+	static constexpr size_t DEFAULT_MEMORY_BUDGET = 64 * 1024 * 1024;
+
+	WorldStreamer() = default;
+	~WorldStreamer();
+
+	// Opens the world and starts the worker, the tileset image is loaded again
+	// as a surface because the textures of the AssetStore can't be read back
+	bool Open(const std::string& worldFilePath, const std::string& tilesetFilePath, int tileSize, double tileScale);
+
+	// Stops the worker and destroys every chunk, must be called once the simulation
+	// and the render thread are stopped and before the renderer is destroyed
+	void Close(bool killEntities = false);
+
+	// Bytes of textures and tiles allowed in memory, the chunks in range are never evicted
+	void SetMemoryBudget(size_t memoryBudget);
+	// Ring of chunks around the camera view loaded in advance
+	void SetPrefetchChunks(int prefetchChunks);
+	void SetMaxUploadsPerFrame(int maxUploadsPerFrame);
+	// Update waits for the worker to load every chunk in range, so they are installed in the
+	// same step on every run, used while recording or replaying
+	void SetSynchronous(bool isSynchronous);
+
+	// The solid tiles of the resident chunks are written into this layer
+	void SetTileCollisionLayer(std::shared_ptr<TileCollisionLayer> collisionLayer, const std::set<int>& solidTileIds);
+	void SetSpawnFunction(SpawnFunction spawnFunction);
+
+	// Simulation side: requests the chunks around the camera, installs the finished ones and evicts over the budget
+	void Update(const Camera& camera);
+
+	// Render side: uploads the new chunks, at most maxUploadsPerFrame, and draws the ones inside the camera view
+	void Render(SDL_Renderer* renderer, const Camera& camera);
+
+	int GetNumCols() const;
+	int GetNumRows() const;
+	float GetWorldWidth() const;
+	float GetWorldHeight() const;
+
+	int GetNumResidentChunks() const;
+	size_t GetMemoryBytes() const;
+	int GetNumChunksDrawn() const;
+	int GetNumChunksLoaded() const;
+	int GetNumChunksEvicted() const;
+};